@@ -0,0 +1,267 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Parameters - The plugin's parameter table and per-block snapshots of it
+ *
+ * Every parameter is one row of `table` (ID, name, type, range, default,
+ * version hint), in the order of Parameters::Id. Hosts and their automation
+ * address parameters by index, so new ones are only ever appended. Each row
+ * carries the version hint of the release that added it: JUCE requires a
+ * later parameter's hint to be higher than every earlier one's, and the AU
+ * wrappers order parameters by it.
+ *
+ * createLayout() builds the APVTS layout from the table, and Cache looks
+ * each parameter's value atomic up once, so the audio thread reads all of
+ * them with plain loads into a Snapshot instead of one string lookup per
+ * parameter and block.
+ *
+ * A snapshot's version only moves when a value differs from the last one,
+ * so values derived from the parameters (gains, multipliers, modes) are
+ * recomputed only when something changed.
+ */
+namespace Parameters
+{
+
+enum class Id
+{
+    InputQ,
+    Color,
+    FilterMode,
+    Drive,
+    OutputLp,
+    OutputGain,
+    Stage2x,
+    Stage5x,
+    Stage10x,
+    PadEnabled,
+    Mix,
+    Oversampling,
+    OsQuality,
+    Adaa,
+    AutoGain,
+    Bands,
+    XoverLow,
+    XoverHigh,
+    LowDrive,
+    MidDrive,
+    HighDrive,
+    Count
+};
+
+inline constexpr size_t count = static_cast<size_t>(Id::Count);
+
+struct Descriptor
+{
+    enum class Type { Float, Choice, Bool };
+
+    Id index;
+    const char* id;
+    const char* name;
+    Type type;
+    float minimum = 0.0f, maximum = 1.0f, interval = 0.0f, skew = 1.0f;   // Float only
+    float defaultValue = 0.0f;                                           // Choice: item index, Bool: 0 or 1
+    const char* choices = "";                                            // Choice only, '|'-separated
+    int versionHint = 1;                                                 // juce::ParameterID version hint
+};
+
+using Type = Descriptor::Type;
+
+constexpr Descriptor floatParameter(Id index, const char* id, const char* name, float minimum, float maximum,
+                                    float interval, float skew, float defaultValue, int versionHint = 1)
+{
+    return { index, id, name, Type::Float, minimum, maximum, interval, skew, defaultValue, "", versionHint };
+}
+
+constexpr Descriptor choiceParameter(Id index, const char* id, const char* name, const char* choices, int defaultItem,
+                                     int versionHint = 1)
+{
+    return { index, id, name, Type::Choice, 0.0f, 1.0f, 0.0f, 1.0f, static_cast<float>(defaultItem), choices, versionHint };
+}
+
+constexpr Descriptor boolParameter(Id index, const char* id, const char* name, bool defaultValue, int versionHint = 1)
+{
+    return { index, id, name, Type::Bool, 0.0f, 1.0f, 0.0f, 1.0f, defaultValue ? 1.0f : 0.0f, "", versionHint };
+}
+
+inline constexpr std::array<Descriptor, count> table {{
+    // === INPUT SECTION (Left) ===
+
+    // Input Filter Q (0.1 - 1.0)
+    floatParameter(Id::InputQ, "INPUT_Q", "Input Q", 0.1f, 1.0f, 0.01f, 1.0f, 0.5f),
+
+    // Input Filter Frequency / Color (20Hz - 20kHz, logarithmic)
+    floatParameter(Id::Color, "COLOR", "Color", 20.0f, 20000.0f, 1.0f, 0.25f, 1000.0f),
+
+    // Filter Mode (HP, LP, BP), default Band Pass
+    choiceParameter(Id::FilterMode, "FILTER_MODE", "Filter Mode", "Low Pass|High Pass|Band Pass", 2),
+
+    // === CENTER SECTION ===
+
+    // Pre-Amp / Drive (0-40 dB), default 0 (no overdrive)
+    floatParameter(Id::Drive, "DRIVE", "Drive", 0.0f, 40.0f, 0.1f, 0.5f, 0.0f),
+
+    // === OUTPUT SECTION (Right) ===
+
+    // Post-Filter / Output LowPass (2kHz - 20kHz, 1-pole LPF), default wide open
+    floatParameter(Id::OutputLp, "OUTPUT_LP", "Post Filter", 2000.0f, 20000.0f, 1.0f, 0.25f, 20000.0f),
+
+    // Post-Gain / Trim (-12 to +12 dB)
+    floatParameter(Id::OutputGain, "OUTPUT_GAIN", "Trim", -12.0f, 12.0f, 0.1f, 1.0f, 0.0f),
+
+    // Ignition Stages (Boolean toggles)
+    boolParameter(Id::Stage2x, "STAGE_2X", "Stage I (2x)", false),
+    boolParameter(Id::Stage5x, "STAGE_5X", "Stage II (5x)", false),
+    boolParameter(Id::Stage10x, "STAGE_10X", "Stage III (10x)", false),
+
+    // Pad Enable (compensates for multiplier gain), default on
+    boolParameter(Id::PadEnabled, "PAD_ENABLED", "Pad", true),
+
+    // Wet/Dry Mix (0-100%), default 100% wet
+    floatParameter(Id::Mix, "MIX", "Mix", 0.0f, 100.0f, 0.1f, 1.0f, 100.0f),
+
+    // === ADDED AFTER v1.0.0 (appended, so the rows above keep their host indices; version hint 2) ===
+
+    // Oversampling factor (trade CPU for aliasing rejection), default 4x
+    choiceParameter(Id::Oversampling, "OVERSAMPLING", "Oversampling", "1x|2x|4x|8x|16x", 2, 2),
+
+    // Oversampling quality: linear-phase FIR (default), or low-latency IIR for tracking
+    choiceParameter(Id::OsQuality, "OS_QUALITY", "Oversampling Quality", "Linear Phase|Live", 0, 2),
+
+    // Antiderivative anti-aliasing (cheap alternative to high oversampling factors), default off
+    choiceParameter(Id::Adaa, "ADAA", "Anti-Derivative AA", "Off|1st Order|2nd Order", 0, 2),
+
+    // Pad mode: static 1/multiplier, or auto gain matching the input level (default the static pad)
+    choiceParameter(Id::AutoGain, "AUTO_GAIN", "Auto Gain", "Off|On|On + Look-ahead", 0, 2),
+
+    // Multiband: split ahead of the drive stage, each band with its own engine (default a single full-band shaper)
+    choiceParameter(Id::Bands, "BANDS", "Bands", "Full Band|2 Bands|3 Bands", 0, 2),
+
+    // Crossovers (Linkwitz-Riley 24 dB/oct); two bands split at the low one
+    floatParameter(Id::XoverLow, "XOVER_LOW", "Low Crossover", 40.0f, 1000.0f, 1.0f, 0.4f, 200.0f, 2),
+    floatParameter(Id::XoverHigh, "XOVER_HIGH", "High Crossover", 1000.0f, 12000.0f, 1.0f, 0.4f, 3000.0f, 2),
+
+    // Per-band drive offsets on top of DRIVE (-20 to +20 dB), in CrossoverBand order
+    floatParameter(Id::LowDrive, "LOW_DRIVE", "Low Drive", -20.0f, 20.0f, 0.1f, 1.0f, 0.0f, 2),
+    floatParameter(Id::MidDrive, "MID_DRIVE", "Mid Drive", -20.0f, 20.0f, 0.1f, 1.0f, 0.0f, 2),
+    floatParameter(Id::HighDrive, "HIGH_DRIVE", "High Drive", -20.0f, 20.0f, 0.1f, 1.0f, 0.0f, 2),
+}};
+
+namespace detail
+{
+    constexpr bool rowsMatchIds()
+    {
+        for (size_t i = 0; i < count; ++i)
+            if (static_cast<size_t>(table[i].index) != i)
+                return false;
+        return true;
+    }
+
+    constexpr bool idsAreUnique()
+    {
+        for (size_t i = 0; i < count; ++i)
+            for (size_t j = i + 1; j < count; ++j)
+                if (std::string_view(table[i].id) == std::string_view(table[j].id))
+                    return false;
+        return true;
+    }
+
+    constexpr bool versionHintsNeverDecrease()
+    {
+        for (size_t i = 1; i < count; ++i)
+            if (table[i].versionHint < table[i - 1].versionHint)
+                return false;
+        return table[0].versionHint >= 1;
+    }
+}
+
+static_assert(detail::rowsMatchIds(), "Parameters::table rows must follow Parameters::Id order");
+static_assert(detail::idsAreUnique(), "Parameters::table has a duplicate parameter ID");
+static_assert(detail::versionHintsNeverDecrease(), "Parameters::table rows added later need a higher version hint");
+
+/** The APVTS layout: one parameter per table row, at the row's version hint */
+inline juce::AudioProcessorValueTreeState::ParameterLayout createLayout()
+{
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+
+    for (const auto& row : table)
+    {
+        const juce::ParameterID parameterId{row.id, row.versionHint};
+
+        switch (row.type)
+        {
+            case Type::Float:
+                params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                    parameterId, row.name,
+                    juce::NormalisableRange<float>(row.minimum, row.maximum, row.interval, row.skew),
+                    row.defaultValue));
+                break;
+
+            case Type::Choice:
+                params.push_back(std::make_unique<juce::AudioParameterChoice>(
+                    parameterId, row.name,
+                    juce::StringArray::fromTokens(row.choices, "|", ""),
+                    static_cast<int>(row.defaultValue)));
+                break;
+
+            case Type::Bool:
+                params.push_back(std::make_unique<juce::AudioParameterBool>(
+                    parameterId, row.name, row.defaultValue > 0.5f));
+                break;
+        }
+    }
+
+    return { params.begin(), params.end() };
+}
+
+/** Every parameter's plain value at one point in time (trivially copyable) */
+struct Snapshot
+{
+    float operator[](Id index) const { return values[static_cast<size_t>(index)]; }
+    bool isOn(Id index) const { return (*this)[index] > 0.5f; }
+    int getChoice(Id index) const { return static_cast<int>((*this)[index]); }
+
+    std::array<float, count> values {};
+    uint32_t version = 0;       // 0 until the first refresh
+};
+
+/** The parameters' value atomics, looked up once per processor */
+class Cache
+{
+public:
+    explicit Cache(juce::AudioProcessorValueTreeState& state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = state.getRawParameterValue(table[i].id);
+            jassert(values[i] != nullptr);
+        }
+    }
+
+    /**
+     * Load every value into snapshot (lock-free, any thread)
+     * @return true if any value changed, in which case the version moved on
+     */
+    bool refresh(Snapshot& snapshot) const
+    {
+        std::array<float, count> current;
+        for (size_t i = 0; i < count; ++i)
+            current[i] = values[i]->load(std::memory_order_relaxed);
+
+        if (snapshot.version != 0 && current == snapshot.values)
+            return false;
+
+        snapshot.values = current;
+        snapshot.version = snapshot.version == UINT32_MAX ? 1 : snapshot.version + 1;
+        return true;
+    }
+
+private:
+    std::array<std::atomic<float>*, count> values {};
+};
+
+} // namespace Parameters
@@ -456,6 +456,53 @@ void OscilloscopeComponent::drawWaveform(juce::Graphics& g, float centreX, float
     g.restoreState();
 }
 
+//==============================================================================
+// DiagnosticsOverlay
+//==============================================================================
+DiagnosticsOverlay::DiagnosticsOverlay()
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+void DiagnosticsOverlay::setStats(const CpuLoadMeter::Stats& newStats)
+{
+    stats = newStats;
+    repaint();
+}
+
+void DiagnosticsOverlay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colour(0xE0080808));
+    g.fillRoundedRectangle(bounds, 6.0f);
+    g.setColour(SanguinovaLookAndFeel::crimsonDark);
+    g.drawRoundedRectangle(bounds.reduced(0.5f), 6.0f, 1.0f);
+
+    auto percent = [](float load) { return juce::String(load * 100.0f, 1) + " %"; };
+
+    const juce::String lines[] {
+        "CPU  " + percent(stats.current),
+        "avg " + percent(stats.average) + "   peak " + percent(stats.peak),
+        "p50 " + percent(stats.p50) + "   p95 " + percent(stats.p95) + "   p99 " + percent(stats.p99),
+        "overruns " + juce::String(static_cast<juce::int64>(stats.overruns)) + " / "
+            + juce::String(static_cast<juce::int64>(stats.blocks)) + " (budget " + percent(stats.budget) + ")"
+    };
+
+    auto area = getLocalBounds().reduced(10, 6);
+    const int numLines = static_cast<int>(std::size(lines));
+    const int lineHeight = area.getHeight() / numLines;
+
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    for (int i = 0; i < numLines; ++i)
+    {
+        // Headline turns red while the last blocks ran over budget
+        const bool overBudget = i == 0 && stats.current > stats.budget;
+        g.setColour(i == 0 ? (overBudget ? SanguinovaLookAndFeel::crimsonBright : SanguinovaLookAndFeel::textLight)
+                           : SanguinovaLookAndFeel::textDim.brighter(0.6f));
+        g.drawText(lines[i], area.removeFromTop(lineHeight), juce::Justification::centredLeft);
+    }
+}
+
 //==============================================================================
 // SanguinovaAudioProcessorEditor
 //==============================================================================
@@ -483,19 +530,31 @@ SanguinovaAudioProcessorEditor::SanguinovaAudioProcessorEditor(SanguinovaAudioPr
     titleLabel.setColour(juce::Label::textColourId, SanguinovaLookAndFeel::crimsonBright);
     titleLabel.setJustificationType(juce::Justification::centredLeft);
     addAndMakeVisible(titleLabel);
+    titleLabel.addMouseListener(this, false);
+
+    // Diagnostics overlay (hidden until the title is clicked)
+    addChildComponent(diagnosticsOverlay);
 
     // Preset Controls
     refreshPresetList();
     presetBox.onChange = [this]() {
-        int idx = presetBox.getSelectedItemIndex();
-        if (idx >= 0)
-            audioProcessor.getPresetManager().loadPreset(idx);
+        // By name: the user list may have been re-indexed since the box was filled
+        if (presetBox.getSelectedItemIndex() >= 0)
+            audioProcessor.getPresetManager().loadPreset(presetBox.getText());
     };
     addAndMakeVisible(presetBox);
 
     savePresetButton.onClick = [this]() { savePresetDialog(); };
     addAndMakeVisible(savePresetButton);
 
+    // Oversampling factor, quality and ADAA
+    oversamplingBox.addItemList({"1x", "2x", "4x", "8x", "16x"}, 1);
+    addAndMakeVisible(oversamplingBox);
+    qualityBox.addItemList({"Linear Phase", "Live"}, 1);
+    addAndMakeVisible(qualityBox);
+    adaaBox.addItemList({"ADAA Off", "ADAA 1", "ADAA 2"}, 1);
+    addAndMakeVisible(adaaBox);
+
     // Knob setup
     auto setupKnob = [this](juce::Slider& knob, juce::Label& label, const juce::String& text,
                             const juce::String& suffix = "") {
@@ -530,6 +589,10 @@ SanguinovaAudioProcessorEditor::SanguinovaAudioProcessorEditor(SanguinovaAudioPr
     filterModeLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(filterModeLabel);
 
+    // Multiband mode (crossovers and band drives are automatable parameters)
+    bandsBox.addItemList({"Full Band", "2 Bands", "3 Bands"}, 1);
+    addAndMakeVisible(bandsBox);
+
     // CENTER - Pre-Amp Section
     setupKnob(driveKnob, driveLabel, "PRE-AMP", " dB");
 
@@ -554,6 +617,10 @@ SanguinovaAudioProcessorEditor::SanguinovaAudioProcessorEditor(SanguinovaAudioPr
     padButton.setButtonText("PAD");
     addAndMakeVisible(padButton);
 
+    // Pad mode: static pad or auto gain
+    autoGainBox.addItemList({"Static Pad", "Auto Gain", "Auto + Look-ahead"}, 1);
+    addAndMakeVisible(autoGainBox);
+
     // Parameter attachments
     inputQAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getState(), "INPUT_Q", inputQKnob);
@@ -567,6 +634,8 @@ SanguinovaAudioProcessorEditor::SanguinovaAudioProcessorEditor(SanguinovaAudioPr
         audioProcessor.getState(), "OUTPUT_GAIN", outputGainKnob);
     filterModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getState(), "FILTER_MODE", filterModeBox);
+    bandsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getState(), "BANDS", bandsBox);
     stage2xAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getState(), "STAGE_2X", stage2xButton);
     stage5xAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
@@ -575,8 +644,16 @@ SanguinovaAudioProcessorEditor::SanguinovaAudioProcessorEditor(SanguinovaAudioPr
         audioProcessor.getState(), "STAGE_10X", stage10xButton);
     padAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getState(), "PAD_ENABLED", padButton);
+    autoGainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getState(), "AUTO_GAIN", autoGainBox);
     mixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getState(), "MIX", mixKnob);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getState(), "OVERSAMPLING", oversamplingBox);
+    qualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getState(), "OS_QUALITY", qualityBox);
+    adaaAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getState(), "ADAA", adaaBox);
 
     startTimerHz(30);
     setSize(820, 580);  // Wider to fit larger center knob
@@ -609,6 +686,13 @@ void SanguinovaAudioProcessorEditor::timerCallback()
     audioProcessor.getScopeData(scopeData);
     oscilloscope.setScopeData(scopeData);
 
+    if (diagnosticsOverlay.isVisible())
+        diagnosticsOverlay.setStats(audioProcessor.getCpuLoadMeter().getStats());
+
+    // Pick up presets indexed in the background
+    if (audioProcessor.getPresetManager().getListGeneration() != presetListGeneration)
+        refreshPresetList();
+
     int mult = static_cast<int>(multiplier);
     multiplierDisplay.setText(juce::String(mult) + "x", juce::dontSendNotification);
 
@@ -622,6 +706,33 @@ void SanguinovaAudioProcessorEditor::timerCallback()
     }
 }
 
+void SanguinovaAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
+{
+    // Clicking the title shows or hides the CPU load overlay
+    if (event.eventComponent != &titleLabel)
+        return;
+
+#if SANGUINOVA_ENABLE_TRACING
+    // Right-click writes the trace ring to the desktop instead
+    if (event.mods.isPopupMenu())
+    {
+        const auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+                              .getChildFile("Sanguinova-trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json")
+                              .getNonexistentSibling();
+
+        const bool started = TraceRecorder::instance().dumpAsync(file.getFullPathName().toStdString());
+        juce::NativeMessageBox::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "Sanguinova Trace",
+                                                    started ? "Writing " + file.getFullPathName()
+                                                            : juce::String("A trace is still being written"),
+                                                    this);
+        return;
+    }
+#endif
+
+    diagnosticsOverlay.setVisible(! diagnosticsOverlay.isVisible());
+    diagnosticsOverlay.toFront(false);
+}
+
 void SanguinovaAudioProcessorEditor::paint(juce::Graphics& g)
 {
     // Obsidian background
@@ -750,7 +861,8 @@ void SanguinovaAudioProcessorEditor::paintOverChildren(juce::Graphics& g)
 
 void SanguinovaAudioProcessorEditor::refreshPresetList()
 {
-    presetBox.clear();
+    presetBox.clear(juce::dontSendNotification);
+    presetListGeneration = audioProcessor.getPresetManager().getListGeneration();
     auto names = audioProcessor.getPresetManager().getPresetNames();
     int id = 1;
     for (const auto& name : names)
@@ -787,7 +899,6 @@ void SanguinovaAudioProcessorEditor::savePresetDialog()
                 if (name.isNotEmpty())
                 {
                     audioProcessor.getPresetManager().savePreset(name);
-                    refreshPresetList();
                 }
             }
             delete alertWindow;
@@ -811,6 +922,11 @@ void SanguinovaAudioProcessorEditor::resized()
     presetArea.removeFromLeft(5);
     savePresetButton.setBounds(presetArea.removeFromLeft(60));
 
+    // Anti-aliasing selectors just left of the preset controls
+    oversamplingBox.setBounds(titleArea.removeFromRight(70).reduced(5, 12));
+    qualityBox.setBounds(titleArea.removeFromRight(120).reduced(5, 12));
+    adaaBox.setBounds(titleArea.removeFromRight(100).reduced(5, 12));
+
     // Three sections - center is wider for large knob
     bounds.reduce(12, 12);
     int totalWidth = bounds.getWidth();
@@ -848,6 +964,10 @@ void SanguinovaAudioProcessorEditor::resized()
     leftSection.removeFromTop(4);
     filterModeBox.setBounds(leftSection.removeFromTop(32).reduced(20, 0));
 
+    // Band count below it
+    leftSection.removeFromTop(8);
+    bandsBox.setBounds(leftSection.removeFromTop(26).reduced(20, 0));
+
     // === CENTER SECTION - Pre-Amp with Oscilloscope ===
     int driveKnobSize = 280;  // 1.75x larger (160 * 1.75)
 
@@ -906,4 +1026,11 @@ void SanguinovaAudioProcessorEditor::resized()
 
     // Pad button
     padButton.setBounds(rightSection.removeFromTop(28).reduced(15, 0));
+
+    // Pad mode below it
+    rightSection.removeFromTop(4);
+    autoGainBox.setBounds(rightSection.removeFromTop(26).reduced(15, 0));
+
+    // Diagnostics overlay in the top right corner, below the header
+    diagnosticsOverlay.setBounds(getWidth() - 276, 62, 268, 78);
 }
@@ -85,6 +85,22 @@ private:
     void drawWaveform(juce::Graphics& g, float centreX, float centreY, float scopeRadius);
 };
 
+/**
+ * DiagnosticsOverlay - CPU load readout drawn over the output panel
+ * Hidden until the title is clicked; never takes mouse clicks itself
+ */
+class DiagnosticsOverlay : public juce::Component
+{
+public:
+    DiagnosticsOverlay();
+
+    void setStats(const CpuLoadMeter::Stats& newStats);
+    void paint(juce::Graphics& g) override;
+
+private:
+    CpuLoadMeter::Stats stats;
+};
+
 /**
  * SanguinovaAudioProcessorEditor - Main UI
  *
@@ -104,6 +120,7 @@ public:
     void paintOverChildren(juce::Graphics&) override;
     void resized() override;
     void timerCallback() override;
+    void mouseDown(const juce::MouseEvent& event) override;
 
 private:
     SanguinovaAudioProcessor& audioProcessor;
@@ -124,12 +141,21 @@ private:
     // Title
     juce::Label titleLabel;
 
+    // CPU load overlay, toggled by clicking the title
+    DiagnosticsOverlay diagnosticsOverlay;
+
     // Preset Controls
     juce::ComboBox presetBox;
     juce::TextButton savePresetButton{"SAVE"};
+    int presetListGeneration = -1;
     void refreshPresetList();
     void savePresetDialog();
 
+    // Oversampling factor and quality
+    juce::ComboBox oversamplingBox;
+    juce::ComboBox qualityBox;
+    juce::ComboBox adaaBox;
+
     // LEFT - Input Section
     juce::Slider inputQKnob;
     juce::Slider colorKnob;
@@ -137,6 +163,7 @@ private:
     juce::Label colorLabel;
     juce::ComboBox filterModeBox;
     juce::Label filterModeLabel;
+    juce::ComboBox bandsBox;
 
     // CENTER - Drive Section
     juce::Slider driveKnob;
@@ -155,6 +182,7 @@ private:
     juce::Label outputGainLabel;
     juce::Label mixLabel;
     juce::ToggleButton padButton;
+    juce::ComboBox autoGainBox;
 
     // Parameter attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> inputQAttachment;
@@ -163,11 +191,16 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputLpAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputGainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bandsAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> stage2xAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> stage5xAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> stage10xAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> padAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> autoGainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> qualityAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> adaaAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SanguinovaAudioProcessorEditor)
 };
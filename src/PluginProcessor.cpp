@@ -5,98 +5,17 @@ SanguinovaAudioProcessor::SanguinovaAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      state(*this, nullptr, "PARAMETERS", createParameterLayout())
+      state(*this, nullptr, "PARAMETERS", Parameters::createLayout())
 {
+#if SANGUINOVA_ENABLE_TRACING
+    TraceRecorder::instance();  // Create (and calibrate) the shared recorder off the audio thread
+#endif
 }
 
 SanguinovaAudioProcessor::~SanguinovaAudioProcessor()
 {
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout SanguinovaAudioProcessor::createParameterLayout()
-{
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-
-    // === INPUT SECTION (Left) ===
-
-    // Input Filter Q (0.1 - 1.0)
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID{"INPUT_Q", 1},
-        "Input Q",
-        juce::NormalisableRange<float>(0.1f, 1.0f, 0.01f),
-        0.5f));
-
-    // Input Filter Frequency / Color (20Hz - 20kHz, logarithmic)
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID{"COLOR", 1},
-        "Color",
-        juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.25f),
-        1000.0f));
-
-    // Filter Mode (HP, LP, BP)
-    params.push_back(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID{"FILTER_MODE", 1},
-        "Filter Mode",
-        juce::StringArray{"Low Pass", "High Pass", "Band Pass"},
-        2));  // Default to Band Pass
-
-    // === CENTER SECTION ===
-
-    // Pre-Amp / Drive (0-40 dB)
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID{"DRIVE", 1},
-        "Drive",
-        juce::NormalisableRange<float>(0.0f, 40.0f, 0.1f, 0.5f),
-        0.0f));  // Default to 0 (no overdrive)
-
-    // === OUTPUT SECTION (Right) ===
-
-    // Post-Filter / Output LowPass (2kHz - 20kHz, 1-pole LPF)
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID{"OUTPUT_LP", 1},
-        "Post Filter",
-        juce::NormalisableRange<float>(2000.0f, 20000.0f, 1.0f, 0.25f),
-        20000.0f));  // Default wide open
-
-    // Post-Gain / Trim (-12 to +12 dB)
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID{"OUTPUT_GAIN", 1},
-        "Trim",
-        juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f),
-        0.0f));
-
-    // Ignition Stages (Boolean toggles)
-    params.push_back(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID{"STAGE_2X", 1},
-        "Stage I (2x)",
-        false));
-
-    params.push_back(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID{"STAGE_5X", 1},
-        "Stage II (5x)",
-        false));
-
-    params.push_back(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID{"STAGE_10X", 1},
-        "Stage III (10x)",
-        false));
-
-    // Pad Enable (compensates for multiplier gain)
-    params.push_back(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID{"PAD_ENABLED", 1},
-        "Pad",
-        true));  // Default on
-
-    // Wet/Dry Mix (0-100%)
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID{"MIX", 1},
-        "Mix",
-        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
-        100.0f));  // Default 100% wet
-
-    return { params.begin(), params.end() };
-}
-
 const juce::String SanguinovaAudioProcessor::getName() const
 {
     return "Sanguinova";
@@ -150,14 +69,31 @@ void SanguinovaAudioProcessor::changeProgramName(int index, const juce::String&
 
 void SanguinovaAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused(samplesPerBlock);
+    // processBlock() walks host blocks in chunks of at most this many samples
+    const int scratchSize = juce::jlimit(1, chunkSize, samplesPerBlock);
+    const int numChannels = juce::jlimit(1, maxChannels, getTotalNumInputChannels());
 
-    // Prepare all DSP components
-    for (int ch = 0; ch < 2; ++ch)
+    // Start every smoother at its parameter's current value (no glide on load)
+    auto resetSmoother = [sampleRate](auto& smoother, float value)
     {
-        preFilters[ch].prepare(static_cast<float>(sampleRate));
-        postFilters[ch].prepare(static_cast<float>(sampleRate));
-    }
+        smoother.reset(sampleRate, smoothingTimeSeconds);
+        smoother.setCurrentAndTargetValue(value);
+    };
+
+    using Id = Parameters::Id;
+    updateParameters();
+
+    resetSmoother(smoothedColor, parameters[Id::Color]);
+    resetSmoother(smoothedOutputLp, parameters[Id::OutputLp]);
+    resetSmoother(smoothedInputQ, parameters[Id::InputQ]);
+    resetSmoother(smoothedDrive, parameters[Id::Drive]);
+    resetSmoother(smoothedOutputGain, derived.outputGain);
+    resetSmoother(smoothedMix, derived.mix);
+    resetSmoother(smoothedLowCrossover, parameters[Id::XoverLow]);
+    resetSmoother(smoothedHighCrossover, parameters[Id::XoverHigh]);
+
+    for (size_t band = 0; band < smoothedBandDrive.size(); ++band)
+        resetSmoother(smoothedBandDrive[band], parameters[bandDriveParameters[band]]);
 
     // Calculate pad smoothing coefficient
     // Fast attack (~5ms), slow release (~150ms) for soft deactivation
@@ -166,34 +102,131 @@ void SanguinovaAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     padAttackCoeff = std::exp(-1.0f / (static_cast<float>(sampleRate) * attackMs / 1000.0f));
     padReleaseCoeff = std::exp(-1.0f / (static_cast<float>(sampleRate) * releaseMs / 1000.0f));
     smoothedPadGain = 1.0f;  // Start at unity
+
+    // The host picks the precision before preparing; the unused path gives its memory back
+    if (isUsingDoublePrecision())
+    {
+        floatPath = {};
+        prepareSignalPath<double>(sampleRate, scratchSize, numChannels);
+    }
+    else
+    {
+        doublePath = {};
+        prepareSignalPath<float>(sampleRate, scratchSize, numChannels);
+    }
+
+    // Load statistics start over with each configuration
+    cpuLoad.prepare(sampleRate);
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::prepareSignalPath(double sampleRate, int scratchSize, int numChannels)
+{
+    auto& path = getSignalPath<FloatType>();
+    using Strip = BasicChannelStrip<FloatType>;
+
+    // One strip per SIMD group of main bus channels (12 channels = 2 strips with AVX, 3 with SSE/NEON;
+    // twice as many in double precision). Multiband runs a lane per band and channel, so the pool
+    // covers the most bands: switching then never allocates.
+    const int numLanes = numChannels * Strip::MaxBands;
+    const int numStrips = (numLanes + Strip::MaxChannels - 1) / Strip::MaxChannels;
+
+    // Prepare all DSP components
+    path.strips.resize(static_cast<size_t>(numStrips));
+    for (auto& strip : path.strips)
+        strip.prepare(sampleRate, scratchSize);
+
+    // Wet path scratch (filtered + distorted), kept separate from the dry input: a channel per lane
+    path.wetBuffer.setSize(numLanes, scratchSize);
+    path.wetGains.assign(static_cast<size_t>(scratchSize), FloatType(1));
+    path.mixGains.assign(static_cast<size_t>(scratchSize), FloatType(1));
+    path.colorRamp.assign(static_cast<size_t>(scratchSize), FloatType(1000));
+
+    // Auto gain, with room for its look-ahead
+    autoGainLookahead = juce::roundToInt(sampleRate * autoGainLookaheadSeconds);
+    path.autoGain.prepare(static_cast<float>(sampleRate), numChannels, autoGainLookahead);
+    path.autoGains.assign(static_cast<size_t>(scratchSize), FloatType(1));
+    autoGainActive = false;
+
+    // Dry path delays, long enough for the slowest oversampling setup plus look-ahead
+    path.dryDelays.resize(static_cast<size_t>(numChannels));
+    for (auto& delay : path.dryDelays)
+        delay.prepare(maxDryDelay + autoGainLookahead);
+    wetPathIdle = false;
+
+    // Assign every lane its band for the current mode
+    activeBands = 0;
+    updateBands(path, derived.numBands, numChannels);
+
+    // Apply the current oversampling setup and report its latency up front
+    updateAntiAliasing(path, derived.oversamplingFactor, derived.liveOversampling, derived.adaaOrder);
+
+    // Engage auto gain up front, so its look-ahead is in the first latency report
+    updateAutoGain(path, derived.autoGainActive, derived.autoGainLookahead);
+    updateLatency(path);  // Strips prepared with an unchanged setup report no change
 }
 
 void SanguinovaAudioProcessor::releaseResources()
 {
-    for (int ch = 0; ch < 2; ++ch)
+    auto release = [](auto& path)
     {
-        preFilters[ch].reset();
-        postFilters[ch].reset();
-        oversamplers[ch].reset();
-    }
+        for (auto& strip : path.strips)
+            strip.reset();
+
+        for (auto& delay : path.dryDelays)
+            delay.reset();
+
+        path.autoGain.reset();
+    };
+
+    release(floatPath);
+    release(doublePath);
 }
 
 bool SanguinovaAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout (mono, stereo, 5.1, 7.1.4, discrete or ambisonic) as long as
+    // input matches output: every channel runs through the same wet path
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    const int numChannels = mainOutput.size();
+
+    if (numChannels < 1 || numChannels > maxChannels)
         return false;
 
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    if (mainOutput != layouts.getMainInputChannelSet())
         return false;
 
     return true;
 }
 
+bool SanguinovaAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
 void SanguinovaAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    process(buffer);
+}
+
+void SanguinovaAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    process(buffer);
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::process(juce::AudioBuffer<FloatType>& buffer)
+{
     juce::ScopedNoDenormals noDenormals;
+    SANGUINOVA_TRACE_BLOCK("processBlock", buffer.getNumSamples());
+
+    auto& path = getSignalPath<FloatType>();
+    auto& strips = path.strips;
+    auto& wetBuffer = path.wetBuffer;
+    auto& autoGain = path.autoGain;
+    using Strip = BasicChannelStrip<FloatType>;
 
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -202,102 +235,405 @@ void SanguinovaAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get parameters
-    float inputQ = *state.getRawParameterValue("INPUT_Q");
-    float color = *state.getRawParameterValue("COLOR");
-    int filterModeInt = static_cast<int>(*state.getRawParameterValue("FILTER_MODE"));
-    float drive = *state.getRawParameterValue("DRIVE");
-    float outputLpFreq = *state.getRawParameterValue("OUTPUT_LP");
-    float outputGainDb = *state.getRawParameterValue("OUTPUT_GAIN");
-    float mixPercent = *state.getRawParameterValue("MIX");
-    float wetAmount = mixPercent / 100.0f;
-    float dryAmount = 1.0f - wetAmount;
+    // Nothing prepared at this precision (the host switched without preparing again)
+    if (strips.empty())
+        return;
 
-    // Calculate stage multipliers (combinatorial)
-    float stage1 = *state.getRawParameterValue("STAGE_2X") > 0.5f ? 2.0f : 1.0f;
-    float stage2 = *state.getRawParameterValue("STAGE_5X") > 0.5f ? 5.0f : 1.0f;
-    float stage3 = *state.getRawParameterValue("STAGE_10X") > 0.5f ? 10.0f : 1.0f;
-    float stageMult = stage1 * stage2 * stage3;
+    // Measured from here, so every begin() is matched by the end() below
+    const uint64_t loadStart = cpuLoad.begin();
 
-    // Calculate pad based on multiplier (compensates for gain increase from overdrive stages)
-    // Pad = 1/multiplier in linear, which equals -20*log10(multiplier) in dB
-    bool padEnabled = *state.getRawParameterValue("PAD_ENABLED") > 0.5f;
-    float targetPadGain = padEnabled ? (1.0f / stageMult) : 1.0f;
-
-    // Store for UI
-    totalMultiplier.store(stageMult);
+    // Get parameters: one snapshot per block, re-derived only when a value changed
+    updateParameters();
+    const float stageMult = derived.stageMult;
+    const SVFFilter::Mode filterMode = derived.filterMode;
 
-    // Convert filter mode
-    SVFFilter::Mode filterMode = static_cast<SVFFilter::Mode>(filterModeInt);
+    // Oversampling factor / quality / ADAA: switching only selects precomputed filters (no allocation)
+    updateAntiAliasing(path, derived.oversamplingFactor, derived.liveOversampling, derived.adaaOrder);
 
-    // Convert output gain from dB to linear
-    float outputGainLinear = juce::Decibels::decibelsToGain(outputGainDb);
+    // In auto mode the pad follows the measured level instead of the stages (AutoGain)
+    updateAutoGain(path, derived.autoGainActive, derived.autoGainLookahead);
+    const float targetPadGain = autoGainActive ? 1.0f : derived.padGain;
 
     // Process each channel
     int numSamples = buffer.getNumSamples();
-    int numChannels = std::min(totalNumInputChannels, 2);
+    int numChannels = std::min(totalNumInputChannels, static_cast<int>(path.dryDelays.size()));
+
+    // Multiband: one wet lane per band and channel, band-major (all channels of
+    // the low band, then the mid, then the high), so lane c is still channel c
+    updateBands(path, derived.numBands, numChannels);
+    const int numBands = activeBands;
+    const int numLanes = numChannels * numBands;
 
     float maxInputLevel = 0.0f;
     float maxOutputLevel = 0.0f;
 
-    for (int channel = 0; channel < numChannels; ++channel)
+    // Run every stage over one cache-sized chunk before moving to the next,
+    // so the wet scratch and oversampled data stay in L1 for large host blocks
+    const int maxChunk = wetBuffer.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += maxChunk)
     {
-        float* channelData = buffer.getWritePointer(channel);
+        const int count = std::min(maxChunk, numSamples - start);
+
+        // A moving COLOR sweeps the pre-filter per sample (fast coefficient path)
+        const bool colorRamping = smoothedColor.isSmoothing();
+        if (colorRamping)
+        {
+            for (int i = 0; i < count; ++i)
+                path.colorRamp[static_cast<size_t>(i)] = smoothedColor.getNextValue();
+        }
+
+        // Update filter and engine parameters to where the smoothers will be
+        // at the end of this chunk. Static values skip the coefficient maths.
+        const float color = colorRamping ? static_cast<float>(path.colorRamp[static_cast<size_t>(count - 1)])
+                                         : smoothedColor.getCurrentValue();
+        const float inputQ = smoothedInputQ.skip(count);
+        const float outputLpFreq = smoothedOutputLp.skip(count);
+        const float drive = smoothedDrive.skip(count);
+        const float lowCrossover = smoothedLowCrossover.skip(count);
+        const float highCrossover = smoothedHighCrossover.skip(count);
+
+        std::array<float, Strip::MaxBands> bandDrive;
+        for (size_t band = 0; band < bandDrive.size(); ++band)
+            bandDrive[band] = smoothedBandDrive[band].skip(count);
+
+        for (auto& strip : strips)
+        {
+            strip.setCrossover(lowCrossover, highCrossover);
+            strip.setParameters(color, inputQ, outputLpFreq, drive, stageMult, bandDrive.data());
+        }
 
-        // Update filter parameters
-        preFilters[channel].setParameters(color, inputQ);
-        postFilters[channel].setFrequency(outputLpFreq);  // 1-pole LPF
+        // Smooth pad transition (fast attack, slow release for soft deactivation).
+        // One gain ramp per chunk, shared by all channels, with the output gain folded in.
+        // Only a gliding pad needs its recursion per sample; a settled one is a constant.
+        if (smoothedPadGain != targetPadGain)
+        {
+            const float coeff = (targetPadGain < smoothedPadGain) ? padAttackCoeff : padReleaseCoeff;
+            for (int i = 0; i < count; ++i)
+            {
+                smoothedPadGain = smoothedPadGain * coeff + targetPadGain * (1.0f - coeff);
+                path.wetGains[static_cast<size_t>(i)] = smoothedPadGain * smoothedOutputGain.getNextValue();
+            }
 
-        for (int sample = 0; sample < numSamples; ++sample)
+            // The recursion only approaches its target: land on it once inaudibly close
+            if (std::abs(smoothedPadGain - targetPadGain) <= padSettleTolerance * targetPadGain)
+                smoothedPadGain = targetPadGain;
+        }
+        else if (smoothedOutputGain.isSmoothing())
         {
-            float input = channelData[sample];
-            maxInputLevel = std::max(maxInputLevel, std::fabs(input));
+            for (int i = 0; i < count; ++i)
+                path.wetGains[static_cast<size_t>(i)] = smoothedPadGain * smoothedOutputGain.getNextValue();
+        }
+        else
+        {
+            std::fill_n(path.wetGains.begin(), count, static_cast<FloatType>(smoothedPadGain * smoothedOutputGain.getCurrentValue()));
+        }
 
-            // 1. Pre-Filter (SVF) - The "Color" stage
-            float filtered = preFilters[channel].processSample(input, filterMode);
+        // Mix ramp, only built while the control is moving
+        const bool mixRamping = smoothedMix.isSmoothing();
+        if (mixRamping)
+        {
+            for (int i = 0; i < count; ++i)
+                path.mixGains[static_cast<size_t>(i)] = smoothedMix.getNextValue();
+        }
 
-            // 2. Distortion Engine with 4x Oversampling
-            float distorted = oversamplers[channel].process(filtered, [&](float x) {
-                return engines[channel].processSample(x, drive, stageMult);
-            });
+        const FloatType wetAmount = smoothedMix.getCurrentValue();
+        const FloatType dryAmount = FloatType(1) - wetAmount;
 
-            // 3. Output 1-pole LowPass Filter (smooths harsh harmonics)
-            float postFiltered = postFilters[channel].processSample(distorted);
+        // MIX held at an end stop needs no blend: 100 % is the wet path alone,
+        // 0 % is the delayed dry signal and skips the wet path altogether
+        const bool dryOnly = !mixRamping && wetAmount == FloatType(0);
+        const bool wetOnly = !mixRamping && wetAmount == FloatType(1);
 
-            // 4. Smooth pad transition (fast attack, slow release for soft deactivation)
-            if (channel == 0)  // Only update once per sample
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const FloatType* channelData = buffer.getReadPointer(channel, start);
+
+            auto inputRange = juce::FloatVectorOperations::findMinAndMax(channelData, count);
+            maxInputLevel = std::max({ maxInputLevel, static_cast<float>(-inputRange.getStart()), static_cast<float>(inputRange.getEnd()) });
+
+            if (! dryOnly)
             {
-                float coeff = (targetPadGain < smoothedPadGain) ? padAttackCoeff : padReleaseCoeff;
-                smoothedPadGain = smoothedPadGain * coeff + targetPadGain * (1.0f - coeff);
+                for (int band = 0; band < numBands; ++band)
+                    std::copy(channelData, channelData + count, wetBuffer.getWritePointer(band * numChannels + channel));
+            }
+        }
+
+        // 1.-3. Pre-filter, oversampled distortion and post-filter,
+        // with the channels of each strip advancing together in SIMD lanes.
+        // Bypassed strips restart from silence when MIX comes back up.
+        if (dryOnly)
+        {
+            if (! wetPathIdle)
+            {
+                for (auto& strip : strips)
+                    strip.reset();
+                autoGain.reset(autoGain.getCurrentGain());
+                wetPathIdle = true;
+            }
+        }
+        else
+        {
+            SANGUINOVA_TRACE_BLOCK("wetPath", count);
+            wetPathIdle = false;
+
+            for (int first = 0, s = 0; first < numLanes; first += Strip::MaxChannels, ++s)
+            {
+                strips[static_cast<size_t>(s)].process(wetBuffer.getArrayOfWritePointers() + first,
+                                                       std::min(Strip::MaxChannels, numLanes - first),
+                                                       count, filterMode, colorRamping ? path.colorRamp.data() : nullptr);
             }
 
-            // 5. Apply smoothed pad (compensates for multiplier gain) and output gain
-            float wetSignal = postFiltered * smoothedPadGain * outputGainLinear;
+            // Sum the bands back into their channels (the crossover keeps them in phase)
+            for (int band = 1; band < numBands; ++band)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    juce::FloatVectorOperations::add(wetBuffer.getWritePointer(channel),
+                                                     wetBuffer.getReadPointer(band * numChannels + channel), count);
+            }
 
-            // 5. Apply wet/dry mix
-            float output = (wetSignal * wetAmount) + (input * dryAmount);
+            // Auto gain: one stereo-linked envelope step per chunk, applied
+            // as a ramp on top of the output gain (wet delayed by the look-ahead)
+            if (autoGainActive)
+            {
+                std::array<const FloatType*, maxChannels> dryChannels;
+                for (int channel = 0; channel < numChannels; ++channel)
+                    dryChannels[static_cast<size_t>(channel)] = buffer.getReadPointer(channel, start);
 
-            channelData[sample] = output;
-            maxOutputLevel = std::max(maxOutputLevel, std::fabs(output));
+                autoGain.process(dryChannels.data(), wetBuffer.getArrayOfWritePointers(), numChannels, count, path.autoGains.data());
+                juce::FloatVectorOperations::multiply(path.wetGains.data(), path.autoGains.data(), count);
+            }
+        }
 
-            // 8. Write to oscilloscope buffer (mono sum, decimated)
-            if (channel == 0)
+        SANGUINOVA_TRACE_BLOCK("mix", count);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            FloatType* channelData = buffer.getWritePointer(channel, start);
+            FloatType* wetData = wetBuffer.getWritePointer(channel);
+
+            // Line the dry signal up with the wet path (kept running at 100 %
+            // so its history is current when MIX comes back down)
+            path.dryDelays[static_cast<size_t>(channel)].processBlock(channelData, count);
+
+            if (wetOnly)
             {
-                if (++scopeDecimation >= scopeDecimationFactor)
+                // 4.-5. Pad and output gain straight into the output
+                juce::FloatVectorOperations::multiply(channelData, wetData, path.wetGains.data(), count);
+            }
+            else if (! dryOnly)
+            {
+                // 4. Apply smoothed pad (compensates for multiplier gain) and output gain
+                juce::FloatVectorOperations::multiply(wetData, path.wetGains.data(), count);
+
+                // 5. Apply wet/dry mix (out = dry + mix * (wet - dry) while gliding)
+                if (mixRamping)
                 {
-                    scopeDecimation = 0;
-                    int pos = scopeWritePos.load();
-                    scopeBuffer[pos].store(output);
-                    scopeWritePos.store((pos + 1) % scopeSize);
+                    juce::FloatVectorOperations::subtract(wetData, channelData, count);
+                    juce::FloatVectorOperations::multiply(wetData, path.mixGains.data(), count);
+                    juce::FloatVectorOperations::add(channelData, wetData, count);
+                }
+                else
+                {
+                    juce::FloatVectorOperations::multiply(channelData, dryAmount, count);
+                    juce::FloatVectorOperations::addWithMultiply(channelData, wetData, wetAmount, count);
                 }
             }
+
+            auto outputRange = juce::FloatVectorOperations::findMinAndMax(channelData, count);
+            maxOutputLevel = std::max({ maxOutputLevel, static_cast<float>(-outputRange.getStart()), static_cast<float>(outputRange.getEnd()) });
+
+            // 6. Write to oscilloscope buffer (first channel, decimated)
+            if (channel == 0)
+                pushToScope(channelData, count);
         }
     }
 
     // Update metering
     currentInputLevel.store(maxInputLevel);
     currentOutputLevel.store(maxOutputLevel);
-    currentGR.store(smoothedPadGain);  // Store smoothed pad value for UI display
+    currentGR.store(autoGainActive ? smoothedPadGain * static_cast<float>(autoGain.getCurrentGain())
+                                   : smoothedPadGain);  // Store smoothed pad value for UI display
+
+    cpuLoad.end(loadStart, numSamples);
+}
+
+void SanguinovaAudioProcessor::updateParameters()
+{
+    if (! parameterCache.refresh(parameters))
+        return;
+
+    using Id = Parameters::Id;
+
+    // Calculate stage multipliers (combinatorial)
+    const float stage1 = parameters.isOn(Id::Stage2x) ? 2.0f : 1.0f;
+    const float stage2 = parameters.isOn(Id::Stage5x) ? 5.0f : 1.0f;
+    const float stage3 = parameters.isOn(Id::Stage10x) ? 10.0f : 1.0f;
+    derived.stageMult = stage1 * stage2 * stage3;
+
+    // Calculate pad based on multiplier (compensates for gain increase from overdrive stages)
+    // Pad = 1/multiplier in linear, which equals -20*log10(multiplier) in dB
+    const bool padEnabled = parameters.isOn(Id::PadEnabled);
+    const int autoGainMode = parameters.getChoice(Id::AutoGain);
+    derived.padGain = padEnabled ? 1.0f / derived.stageMult : 1.0f;
+    derived.autoGainActive = padEnabled && autoGainMode > 0;
+    derived.autoGainLookahead = autoGainMode == 2;
+
+    derived.filterMode = static_cast<SVFFilter::Mode>(parameters.getChoice(Id::FilterMode));
+    derived.numBands = parameters.getChoice(Id::Bands) + 1;
+    derived.oversamplingFactor = 1 << parameters.getChoice(Id::Oversampling);
+    derived.liveOversampling = parameters.isOn(Id::OsQuality);
+    derived.adaaOrder = parameters.getChoice(Id::Adaa);
+    derived.outputGain = juce::Decibels::decibelsToGain(parameters[Id::OutputGain]);
+    derived.mix = parameters[Id::Mix] / 100.0f;
+
+    // Continuous controls become smoother targets
+    smoothedInputQ.setTargetValue(parameters[Id::InputQ]);
+    smoothedColor.setTargetValue(parameters[Id::Color]);
+    smoothedDrive.setTargetValue(parameters[Id::Drive]);
+    smoothedOutputLp.setTargetValue(parameters[Id::OutputLp]);
+    smoothedOutputGain.setTargetValue(derived.outputGain);
+    smoothedMix.setTargetValue(derived.mix);
+    smoothedLowCrossover.setTargetValue(parameters[Id::XoverLow]);
+    smoothedHighCrossover.setTargetValue(parameters[Id::XoverHigh]);
+
+    for (size_t band = 0; band < smoothedBandDrive.size(); ++band)
+        smoothedBandDrive[band].setTargetValue(parameters[bandDriveParameters[band]]);
+
+    // Store for UI
+    totalMultiplier.store(derived.stageMult);
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::updateAntiAliasing(SignalPath<FloatType>& path, int factor, bool live, int adaaOrder)
+{
+    if (path.strips.empty())
+        return;
+
+    bool changed = false;
+    for (auto& strip : path.strips)
+        changed |= strip.setAntiAliasing(factor, live, adaaOrder);
+
+    if (changed)
+        updateLatency(path);
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::updateBands(SignalPath<FloatType>& path, int numBands, int numChannels)
+{
+    using Strip = BasicChannelStrip<FloatType>;
+
+    numBands = juce::jlimit(1, Strip::MaxBands, numBands);
+    if (numBands == activeBands || path.strips.empty())
+        return;
+
+    // Two bands are low and high; the mid band only exists with three
+    const CrossoverBand order[2][Strip::MaxBands] = {
+        { CrossoverBand::Low, CrossoverBand::High, CrossoverBand::High },
+        { CrossoverBand::Low, CrossoverBand::Mid, CrossoverBand::High },
+    };
+    const auto& bandOfLane = order[numBands == 3 ? 1 : 0];
+
+    // Lane groups carry different signals now: start them from silence
+    for (size_t s = 0; s < path.strips.size(); ++s)
+    {
+        std::array<CrossoverBand, Strip::MaxChannels> bands;
+        for (int lane = 0; lane < Strip::MaxChannels; ++lane)
+        {
+            const int wetLane = static_cast<int>(s) * Strip::MaxChannels + lane;
+            bands[static_cast<size_t>(lane)] = bandOfLane[std::min(wetLane / std::max(1, numChannels), numBands - 1)];
+        }
+
+        path.strips[s].setBands(numBands, bands.data());
+        path.strips[s].reset();
+    }
+
+    activeBands = numBands;
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::updateLatency(SignalPath<FloatType>& path)
+{
+    if (path.strips.empty())
+        return;
+
+    // The host can only compensate whole samples; the dry path gets the
+    // exact (fractional) group delay so the blend doesn't comb filter
+    const float latency = path.strips[0].getLatencyInSamples() + static_cast<float>(path.autoGain.getLookahead());
+    setLatencySamples(juce::roundToInt(latency));
+
+    for (auto& delay : path.dryDelays)
+        delay.setDelay(latency);
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::updateAutoGain(SignalPath<FloatType>& path, bool active, bool useLookahead)
+{
+    auto& autoGain = path.autoGain;
+
+    // Hand the compensation over without a level jump: auto gain starts from
+    // the pad's current gain, and the pad glides on from the auto gain
+    if (active != autoGainActive)
+    {
+        if (active)
+        {
+            autoGain.reset(static_cast<FloatType>(smoothedPadGain));
+            smoothedPadGain = 1.0f;
+        }
+        else
+        {
+            smoothedPadGain *= static_cast<float>(autoGain.getCurrentGain());
+        }
+
+        autoGainActive = active;
+    }
+
+    // Look-ahead delays the wet path, so it changes the reported latency
+    const int lookahead = active && useLookahead ? autoGainLookahead : 0;
+    if (lookahead != autoGain.getLookahead())
+    {
+        autoGain.setLookahead(lookahead);
+        updateLatency(path);
+    }
+}
+
+template <typename FloatType>
+void SanguinovaAudioProcessor::pushToScope(const FloatType* data, int numSamples)
+{
+    // Every scopeDecimationFactor-th sample, continuing the phase across calls
+    std::array<float, chunkSize / scopeDecimationFactor + 1> decimated;
+    int numDecimated = 0;
+
+    for (int sample = scopeDecimationFactor - 1 - scopeDecimation; sample < numSamples; sample += scopeDecimationFactor)
+        decimated[static_cast<size_t>(numDecimated++)] = static_cast<float>(data[sample]);
+
+    scopeDecimation = (scopeDecimation + numSamples) % scopeDecimationFactor;
+
+    // One write for the whole chunk; if the editor isn't draining, the overflow is dropped
+    const auto scope = scopeFifo.write(numDecimated);
+    std::copy_n(decimated.begin(), scope.blockSize1, scopeFifoBuffer.begin() + scope.startIndex1);
+    std::copy_n(decimated.begin() + scope.blockSize1, scope.blockSize2, scopeFifoBuffer.begin() + scope.startIndex2);
+}
+
+void SanguinovaAudioProcessor::getScopeData(std::array<float, scopeSize>& data)
+{
+    // Slide everything published since the last call into the display window
+    auto append = [this](const float* source, int numSamples)
+    {
+        const int kept = std::min(numSamples, scopeSize);
+        source += numSamples - kept;
+
+        std::move(scopeHistory.begin() + kept, scopeHistory.end(), scopeHistory.begin());
+        std::copy_n(source, kept, scopeHistory.end() - kept);
+    };
+
+    {
+        const auto scope = scopeFifo.read(scopeFifo.getNumReady());
+        append(scopeFifoBuffer.data() + scope.startIndex1, scope.blockSize1);
+        append(scopeFifoBuffer.data() + scope.startIndex2, scope.blockSize2);
+    }
+
+    data = scopeHistory;
 }
 
 bool SanguinovaAudioProcessor::hasEditor() const
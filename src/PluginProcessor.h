@@ -2,11 +2,12 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_utils/juce_audio_utils.h>
-#include "dsp/SanguinovaEngine.h"
-#include "dsp/SVFFilter.h"
-#include "dsp/OnePole.h"
-#include "dsp/Oversampler.h"
+#include "dsp/ChannelStrip.h"
+#include "dsp/DelayLine.h"
+#include "dsp/AutoGain.h"
+#include "diagnostics/CpuLoadMeter.h"
 #include "PresetManager.h"
+#include "Parameters.h"
 
 /**
  * SanguinovaAudioProcessor
@@ -16,6 +17,7 @@
  * - Asymmetric waveshaping (tube-like saturation)
  * - Multi-mode SVF pre-filter (Color control)
  * - Ignition Stages (2x, 5x, 10x combinatorial multipliers)
+ * - Optional 2- or 3-band mode with per-band drive offsets
  * - Intelligent auto-gain compensation
  */
 class SanguinovaAudioProcessor : public juce::AudioProcessor
@@ -28,6 +30,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -60,45 +64,146 @@ public:
     float getCurrentGainReduction() const { return currentGR.load(); }
     float getTotalMultiplier() const { return totalMultiplier.load(); }
 
-    // Oscilloscope buffer access
+    // CPU load of processBlock() (stats readable from any thread)
+    CpuLoadMeter& getCpuLoadMeter() { return cpuLoad; }
+
+    // Oscilloscope buffer access (consumer side: call from the message thread only)
     static constexpr int scopeSize = 256;
-    void getScopeData(std::array<float, scopeSize>& data) const
-    {
-        int pos = scopeWritePos.load();
-        for (int i = 0; i < scopeSize; ++i)
-        {
-            int idx = (pos + i) % scopeSize;
-            data[i] = scopeBuffer[idx].load();
-        }
-    }
+    void getScopeData(std::array<float, scopeSize>& data);
 
 private:
     juce::AudioProcessorValueTreeState state;
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    Parameters::Cache parameterCache{state};
     PresetManager presetManager{state};
 
-    // DSP Components (per channel)
-    std::array<SanguinovaEngine, 2> engines;
-    std::array<SVFFilter, 2> preFilters;
-    std::array<OnePole, 2> postFilters;  // 1-pole LPF for smoothing
-    std::array<Oversampler, 2> oversamplers;  // 4x oversampling
+    // This block's parameter values, and what processBlock() derives from them
+    // (recomputed only when the snapshot's version moves on)
+    struct DerivedParameters
+    {
+        float stageMult = 1.0f;               // Combined ignition stage multiplier
+        float padGain = 1.0f;                 // Static pad: 1 / stageMult, or unity with PAD off
+        bool autoGainActive = false;          // PAD in auto mode
+        bool autoGainLookahead = false;
+        SVFFilter::Mode filterMode = SVFFilter::Mode::BandPass;
+        int numBands = 1;
+        int oversamplingFactor = 4;
+        bool liveOversampling = false;
+        int adaaOrder = 0;
+        float outputGain = 1.0f;              // TRIM as a linear gain
+        float mix = 1.0f;                     // Wet amount, 0-1
+    };
+
+    Parameters::Snapshot parameters;
+    DerivedParameters derived;
+
+    // Take this block's parameter snapshot; on a change, re-derive and retarget the smoothers
+    void updateParameters();
+
+    // DSP Components and scratch for one sample type. Only the path matching
+    // the host's processing precision is prepared; the other stays empty, so
+    // double-precision hosts run the whole chain in double without converting.
+    template <typename FloatType>
+    struct SignalPath
+    {
+        // A pool of strips sized in prepareToPlay(), one per group of
+        // MaxChannels wet lanes: a lane per channel of the main bus, or
+        // per band and channel in multiband mode
+        std::vector<BasicChannelStrip<FloatType>> strips;
+        juce::AudioBuffer<FloatType> wetBuffer;           // Per-lane wet path scratch (one chunk)
+        std::vector<FloatType> wetGains;                  // Pad * output gain ramp for one chunk
+        std::vector<FloatType> mixGains;                  // Wet amount ramp for one chunk (while MIX moves)
+        std::vector<FloatType> colorRamp;                 // Per-sample pre-filter cutoff for one chunk (while COLOR moves)
+        std::vector<BasicDelayLine<FloatType>> dryDelays; // Per-channel dry path delay (exact wet path latency)
+        BasicAutoGain<FloatType> autoGain;                // Auto gain (PAD in auto mode)
+        std::vector<FloatType> autoGains;                 // Auto gain ramp for one chunk
+    };
+
+    template <typename FloatType>
+    SignalPath<FloatType>& getSignalPath()
+    {
+        if constexpr (std::is_same_v<FloatType, double>)
+            return doublePath;
+        else
+            return floatPath;
+    }
+
+    // Allocate the path for the current setup and apply the current parameters to it
+    template <typename FloatType>
+    void prepareSignalPath(double sampleRate, int scratchSize, int numChannels);
+
+    // processBlock() for either precision
+    template <typename FloatType>
+    void process(juce::AudioBuffer<FloatType>& buffer);
+
+    // Switch oversampling factor / quality / ADAA order and report the resulting latency to the host
+    template <typename FloatType>
+    void updateAntiAliasing(SignalPath<FloatType>& path, int factor, bool live, int adaaOrder);
+
+    // Switch the band count: reassign every strip lane's band and restart the strips
+    template <typename FloatType>
+    void updateBands(SignalPath<FloatType>& path, int numBands, int numChannels);
+
+    // Report the wet path's latency to the host and delay the dry path to match
+    template <typename FloatType>
+    void updateLatency(SignalPath<FloatType>& path);
+
+    // Switch between the static pad and auto gain (with or without look-ahead)
+    template <typename FloatType>
+    void updateAutoGain(SignalPath<FloatType>& path, bool active, bool useLookahead);
+
+    // Decimate output samples and publish them to the oscilloscope FIFO
+    template <typename FloatType>
+    void pushToScope(const FloatType* data, int numSamples);
+
+    static constexpr int maxChannels = 64;    // Largest discrete bus accepted
+    SignalPath<float> floatPath;
+    SignalPath<double> doublePath;
+    bool wetPathIdle = false;                 // MIX held at 0: strips are reset and skipped
+    int activeBands = 1;                      // Bands the strip lanes are currently assigned to
+    static constexpr int maxDryDelay = Oversampler::MaxFilterOrder + 2;  // FIR latency plus ADAA, before look-ahead
+
+    // Auto gain (PAD in auto mode) replaces the static 1/multiplier pad
+    static constexpr double autoGainLookaheadSeconds = 0.002;
+    bool autoGainActive = false;
+    int autoGainLookahead = 0;                // Look-ahead in samples at the current rate
+
+    // Continuous controls glide instead of stepping once per block. COLOR,
+    // gain and mix are applied per sample; the other filter and drive values
+    // are taken once per chunk (the DSP interpolates its coefficients within it).
+    static constexpr double smoothingTimeSeconds = 0.02;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedColor, smoothedOutputLp;
+    juce::SmoothedValue<float> smoothedInputQ, smoothedDrive, smoothedOutputGain, smoothedMix;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedLowCrossover, smoothedHighCrossover;
+    std::array<juce::SmoothedValue<float>, 3> smoothedBandDrive;   // Drive offsets, indexed by CrossoverBand
+    static constexpr Parameters::Id bandDriveParameters[3] = { Parameters::Id::LowDrive,
+                                                               Parameters::Id::MidDrive,
+                                                               Parameters::Id::HighDrive };
+
+    // Stages run chunk by chunk: 64 samples (256 at 4x) keep every scratch in L1
+    static constexpr int chunkSize = 64;
 
     // Pad smoothing (soft release on deactivation)
     float smoothedPadGain = 1.0f;
     float padAttackCoeff = 0.0f;
     float padReleaseCoeff = 0.0f;
+    static constexpr float padSettleTolerance = 1.0e-5f;   // Relative distance at which the pad snaps to its target
 
     // Metering
     std::atomic<float> currentInputLevel{0.0f};
     std::atomic<float> currentOutputLevel{0.0f};
     std::atomic<float> currentGR{1.0f};
     std::atomic<float> totalMultiplier{1.0f};
-
-    // Oscilloscope circular buffer
-    std::array<std::atomic<float>, scopeSize> scopeBuffer{};
-    std::atomic<int> scopeWritePos{0};
+    CpuLoadMeter cpuLoad;
+
+    // Oscilloscope: single-producer/single-consumer FIFO of decimated output.
+    // The audio thread publishes each chunk with one index store; the editor
+    // drains it into scopeHistory, so it never sees a half-written frame.
+    static constexpr int scopeFifoSize = 4096;
+    static constexpr int scopeDecimationFactor = 8;  // Downsample for display
+    juce::AbstractFifo scopeFifo{scopeFifoSize};
+    std::array<float, scopeFifoSize> scopeFifoBuffer{};
+    std::array<float, scopeSize> scopeHistory{};     // Consumer-owned display window
     int scopeDecimation = 0;
-    int scopeDecimationFactor = 8;  // Downsample for display
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SanguinovaAudioProcessor)
 };
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "diagnostics/TraceRecorder.h"
+
+/**
+ * PresetIndex - Background index of the user preset directory
+ *
+ * Listing a large preset library and reading every file is slow, and slower
+ * still on a network-mounted home, so none of it runs on the caller's
+ * thread. One index thread per process, shared by every plugin instance
+ * through juce::SharedResourcePointer, keeps name, file, modification time,
+ * size and the saved parameter values of each preset:
+ *
+ * - On start it publishes the index persisted by the previous run
+ *   (PresetIndex.xml next to the preset directory), then checks it against
+ *   the directory, re-reading only files whose time or size changed.
+ * - It then polls the directory's modification time (one stat per interval)
+ *   and rescans the same way when that moves. Native change notifications
+ *   miss other machines' writes on network shares; polling doesn't.
+ * - fileChanged() re-indexes a single file without waiting for a scan.
+ *
+ * Readers take an immutable Snapshot, so a lookup never waits on a scan and
+ * find() is a hash lookup. getGeneration() changes with every new snapshot.
+ */
+class PresetIndex : private juce::Thread
+{
+public:
+    struct Entry
+    {
+        juce::String name;
+        juce::File file;
+        juce::int64 modified = 0;           // Milliseconds since the epoch
+        juce::int64 size = 0;
+        juce::NamedValueSet parameters;     // Parameter ID -> saved value
+    };
+
+    struct NameHash
+    {
+        size_t operator()(const juce::String& name) const noexcept { return name.hash(); }
+    };
+
+    struct Snapshot
+    {
+        /** The preset with this name, or nullptr */
+        std::shared_ptr<const Entry> find(const juce::String& name) const
+        {
+            auto it = byName.find(name);
+            return it != byName.end() ? entries[it->second] : nullptr;
+        }
+
+        std::vector<std::shared_ptr<const Entry>> entries;    // Sorted by file
+        std::unordered_map<juce::String, size_t, NameHash> byName;
+    };
+
+    PresetIndex()
+        : juce::Thread("Sanguinova Preset Index"),
+          directory(getDefaultDirectory()),
+          cacheFile(directory.getSiblingFile("PresetIndex.xml"))
+    {
+        startThread(juce::Thread::Priority::background);
+    }
+
+    ~PresetIndex() override
+    {
+        stopThread(10000);
+    }
+
+    static juce::File getDefaultDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("SeshNx")
+            .getChildFile("Sanguinova")
+            .getChildFile("Presets");
+    }
+
+    const juce::File& getDirectory() const { return directory; }
+
+    std::shared_ptr<const Snapshot> getSnapshot() const
+    {
+        const juce::ScopedLock lock(snapshotLock);
+        return snapshot;
+    }
+
+    int getGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    /** Re-index one file (written, replaced or deleted) ahead of the next scan */
+    void fileChanged(const juce::File& file)
+    {
+        {
+            const juce::ScopedLock lock(pendingLock);
+            pendingFiles.addIfNotAlreadyThere(file);
+        }
+        notify();
+    }
+
+    /** Rescan the whole directory on the index thread */
+    void rescan()
+    {
+        rescanRequested = true;
+        notify();
+    }
+
+private:
+    static constexpr int pollIntervalMs = 2000;
+    static constexpr int cacheVersion = 1;
+
+    using Entries = std::vector<std::shared_ptr<const Entry>>;
+
+    void run() override
+    {
+        publish(loadCache());
+        cacheNeedsWriting = false;
+
+        juce::Time scannedTime;
+        double confirmAt = 0.0;
+        bool scanned = false;
+
+        while (! threadShouldExit())
+        {
+            updatePendingFiles();
+
+            const auto time = directory.getLastModificationTime();
+            const auto now = juce::Time::getMillisecondCounterHiRes();
+            const bool changed = time != scannedTime;
+            const bool confirm = confirmAt > 0.0 && now >= confirmAt;
+
+            if (! scanned || changed || confirm || rescanRequested.exchange(false))
+            {
+                // Another change within the time's resolution (a second on some file systems)
+                // wouldn't move it again, so a changed directory is scanned once more after that
+                confirmAt = changed ? now + pollIntervalMs : 0.0;
+                scannedTime = time;
+                scanned = true;
+                scan();
+            }
+
+            // Once per pass, however many updates it published
+            if (cacheNeedsWriting)
+            {
+                cacheNeedsWriting = false;
+                saveCache(*getSnapshot());
+            }
+
+            wait(pollIntervalMs);
+        }
+    }
+
+    void scan()
+    {
+        SANGUINOVA_TRACE_SCOPE("PresetIndex::scan");
+
+        if (! directory.isDirectory())
+            directory.createDirectory();
+
+        if (! directory.isDirectory())
+            return;     // Unreachable (share offline): keep the last index until it's back
+
+        const auto previous = getSnapshot();
+        Entries entries;
+
+        for (const auto& item : juce::RangedDirectoryIterator(directory, false, "*.xml", juce::File::findFiles))
+        {
+            if (threadShouldExit())
+                return;
+
+            const auto file = item.getFile();
+            const auto modified = item.getModificationTime().toMilliseconds();
+            const auto size = item.getFileSize();
+
+            // Unchanged files keep their entry without being read again
+            auto known = previous->find(file.getFileNameWithoutExtension());
+            if (known != nullptr && known->file == file && known->modified == modified && known->size == size)
+                entries.push_back(std::move(known));
+            else
+                entries.push_back(readEntry(file, modified, size));
+        }
+
+        publish(std::move(entries));
+    }
+
+    void updatePendingFiles()
+    {
+        juce::Array<juce::File> files;
+        {
+            const juce::ScopedLock lock(pendingLock);
+            files.swapWith(pendingFiles);
+        }
+
+        if (files.isEmpty())
+            return;
+
+        SANGUINOVA_TRACE_SCOPE("PresetIndex::updatePendingFiles");
+        auto entries = getSnapshot()->entries;
+
+        for (const auto& file : files)
+        {
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [&file](const auto& entry) { return entry->file == file; }),
+                          entries.end());
+
+            if (file.existsAsFile())
+                entries.push_back(readEntry(file, file.getLastModificationTime().toMilliseconds(), file.getSize()));
+        }
+
+        publish(std::move(entries));
+    }
+
+    static std::shared_ptr<const Entry> readEntry(const juce::File& file, juce::int64 modified, juce::int64 size)
+    {
+        auto entry = std::make_shared<Entry>();
+        entry->name = file.getFileNameWithoutExtension();
+        entry->file = file;
+        entry->modified = modified;
+        entry->size = size;
+
+        if (auto xml = juce::XmlDocument::parse(file))
+            readParameters(*xml, entry->parameters);
+
+        return entry;
+    }
+
+    /** PARAM children as written by the APVTS state and by saveCache() */
+    static void readParameters(const juce::XmlElement& xml, juce::NamedValueSet& parameters)
+    {
+        for (auto* param : xml.getChildWithTagNameIterator("PARAM"))
+        {
+            const auto id = param->getStringAttribute("id");
+            if (id.isNotEmpty())
+                parameters.set(id, param->getDoubleAttribute("value"));
+        }
+    }
+
+    /** Sort, index and publish entries unless nothing changed */
+    void publish(Entries entries)
+    {
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& a, const auto& b) { return a->file < b->file; });
+
+        const auto previous = getSnapshot();
+        if (entries == previous->entries)
+            return;
+
+        auto next = std::make_shared<Snapshot>();
+        next->entries = std::move(entries);
+        for (size_t i = 0; i < next->entries.size(); ++i)
+            next->byName.emplace(next->entries[i]->name, i);     // First file wins a name clash
+
+        {
+            const juce::ScopedLock lock(snapshotLock);
+            snapshot = next;
+        }
+        generation.fetch_add(1, std::memory_order_release);
+        cacheNeedsWriting = true;
+    }
+
+    Entries loadCache() const
+    {
+        Entries entries;
+        auto xml = juce::XmlDocument::parse(cacheFile);
+
+        if (xml == nullptr || ! xml->hasTagName("PRESETINDEX")
+            || xml->getIntAttribute("version") != cacheVersion
+            || xml->getStringAttribute("directory") != directory.getFullPathName())
+            return entries;
+
+        for (auto* preset : xml->getChildWithTagNameIterator("PRESET"))
+        {
+            auto entry = std::make_shared<Entry>();
+            entry->file = juce::File(preset->getStringAttribute("file"));
+            entry->name = entry->file.getFileNameWithoutExtension();
+            entry->modified = preset->getStringAttribute("modified").getLargeIntValue();
+            entry->size = preset->getStringAttribute("size").getLargeIntValue();
+            readParameters(*preset, entry->parameters);
+            entries.push_back(std::move(entry));
+        }
+
+        return entries;
+    }
+
+    /** Replaces the file atomically, so instances in other processes never read half of it */
+    void saveCache(const Snapshot& index) const
+    {
+        SANGUINOVA_TRACE_SCOPE("PresetIndex::saveCache");
+
+        juce::XmlElement xml("PRESETINDEX");
+        xml.setAttribute("version", cacheVersion);
+        xml.setAttribute("directory", directory.getFullPathName());
+
+        for (const auto& entry : index.entries)
+        {
+            auto* preset = xml.createNewChildElement("PRESET");
+            preset->setAttribute("file", entry->file.getFullPathName());
+            preset->setAttribute("modified", juce::String(entry->modified));
+            preset->setAttribute("size", juce::String(entry->size));
+
+            for (const auto& parameter : entry->parameters)
+            {
+                auto* param = preset->createNewChildElement("PARAM");
+                param->setAttribute("id", parameter.name.toString());
+                param->setAttribute("value", static_cast<double>(parameter.value));
+            }
+        }
+
+        xml.writeTo(cacheFile);
+    }
+
+    const juce::File directory;
+    const juce::File cacheFile;
+
+    juce::CriticalSection snapshotLock;
+    std::shared_ptr<const Snapshot> snapshot = std::make_shared<const Snapshot>();
+    std::atomic<int> generation{0};
+
+    juce::CriticalSection pendingLock;
+    juce::Array<juce::File> pendingFiles;
+    std::atomic<bool> rescanRequested{false};
+    bool cacheNeedsWriting = false;     // Index thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetIndex)
+};
@@ -2,6 +2,8 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
+#include "diagnostics/TraceRecorder.h"
+#include "PresetIndex.h"
 
 /**
  * PresetManager - Handles preset save/load/browse
@@ -9,6 +11,11 @@
  * Supports:
  * - Factory presets (built-in)
  * - User presets (saved to disk)
+ *
+ * User presets come from the process-wide PresetIndex, so constructing a
+ * manager touches no files and name lookups are hash lookups. The user list
+ * fills in once the index thread has caught up; getListGeneration() tells
+ * the editor when to rebuild its list.
  */
 class PresetManager
 {
@@ -18,17 +25,8 @@ public:
     {
         initFactoryPresets();
 
-        // Create user preset directory
-        userPresetDir = juce::File::getSpecialLocation(
-            juce::File::userApplicationDataDirectory)
-            .getChildFile("SeshNx")
-            .getChildFile("Sanguinova")
-            .getChildFile("Presets");
-
-        if (!userPresetDir.exists())
-            userPresetDir.createDirectory();
-
-        refreshPresetList();
+        // The index thread creates the user preset directory and scans it
+        userPresetDir = presetIndex->getDirectory();
     }
 
     // Get list of all presets (factory + user)
@@ -37,8 +35,8 @@ public:
         juce::StringArray names;
         for (const auto& preset : factoryPresets)
             names.add(preset.name);
-        for (const auto& file : userPresetFiles)
-            names.add(file.getFileNameWithoutExtension());
+        for (const auto& entry : presetIndex->getSnapshot()->entries)
+            names.add(entry->name);
         return names;
     }
 
@@ -47,6 +45,8 @@ public:
     // Load preset by index
     bool loadPreset(int index)
     {
+        SANGUINOVA_TRACE_SCOPE("PresetManager::loadPreset");
+
         if (index < 0)
             return false;
 
@@ -58,11 +58,12 @@ public:
             return true;
         }
 
-        int userIndex = index - static_cast<int>(factoryPresets.size());
-        if (userIndex < static_cast<int>(userPresetFiles.size()))
+        auto userIndex = static_cast<size_t>(index) - factoryPresets.size();
+        auto snapshot = presetIndex->getSnapshot();
+        if (userIndex < snapshot->entries.size())
         {
             // User preset
-            return loadPresetFromFile(userPresetFiles[userIndex]);
+            return loadPresetFromFile(snapshot->entries[userIndex]->file);
         }
 
         return false;
@@ -79,18 +80,19 @@ public:
         }
 
         // Check user presets
-        for (size_t i = 0; i < userPresetFiles.size(); ++i)
-        {
-            if (userPresetFiles[i].getFileNameWithoutExtension() == name)
-                return loadPreset(static_cast<int>(factoryPresets.size() + i));
-        }
+        if (auto entry = presetIndex->getSnapshot()->find(name))
+            return loadPresetFromFile(entry->file);
 
-        return false;
+        // Not indexed yet (first scan still running, or just saved by another instance)
+        auto file = userPresetDir.getChildFile(name + ".xml");
+        return file.existsAsFile() && loadPresetFromFile(file);
     }
 
     // Save current state as user preset
     bool savePreset(const juce::String& name)
     {
+        SANGUINOVA_TRACE_SCOPE("PresetManager::savePreset");
+        userPresetDir.createDirectory();
         auto file = userPresetDir.getChildFile(name + ".xml");
         auto stateTree = state.copyState();
         auto xml = stateTree.createXml();
@@ -98,7 +100,7 @@ public:
         if (xml != nullptr && xml->writeTo(file))
         {
             currentPresetName = name;
-            refreshPresetList();
+            presetIndex->fileChanged(file);
             return true;
         }
         return false;
@@ -107,11 +109,12 @@ public:
     // Delete a user preset
     bool deletePreset(const juce::String& name)
     {
+        SANGUINOVA_TRACE_SCOPE("PresetManager::deletePreset");
         auto file = userPresetDir.getChildFile(name + ".xml");
         if (file.existsAsFile())
         {
             file.deleteFile();
-            refreshPresetList();
+            presetIndex->fileChanged(file);
             return true;
         }
         return false;
@@ -119,18 +122,31 @@ public:
 
     const juce::String& getCurrentPresetName() const { return currentPresetName; }
 
-    void refreshPresetList()
-    {
-        userPresetFiles.clear();
-        auto files = userPresetDir.findChildFiles(
-            juce::File::findFiles, false, "*.xml");
-        files.sort();
-        for (const auto& f : files)
-            userPresetFiles.push_back(f);
-    }
+    // Rescan the user preset directory in the background
+    void refreshPresetList() { presetIndex->rescan(); }
+
+    // Changes whenever the user preset list may have changed
+    int getListGeneration() const { return presetIndex->getGeneration(); }
 
     juce::File getUserPresetDirectory() const { return userPresetDir; }
 
+    // Indexed user presets (name, file, time, size and saved parameter values)
+    std::shared_ptr<const PresetIndex::Snapshot> getUserPresets() const { return presetIndex->getSnapshot(); }
+
+    // Load a preset file saved by savePreset() from anywhere on disk
+    bool loadPresetFromFile(const juce::File& file)
+    {
+        SANGUINOVA_TRACE_SCOPE("PresetManager::loadPresetFromFile");
+        auto xml = juce::XmlDocument::parse(file);
+        if (xml != nullptr && xml->hasTagName(state.state.getType()))
+        {
+            state.replaceState(juce::ValueTree::fromXml(*xml));
+            currentPresetName = file.getFileNameWithoutExtension();
+            return true;
+        }
+        return false;
+    }
+
 private:
     struct FactoryPreset
     {
@@ -154,6 +170,7 @@ private:
                 {"STAGE_5X", 0.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 100.0f}
             }
         });
@@ -172,6 +189,7 @@ private:
                 {"STAGE_5X", 0.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 70.0f}
             }
         });
@@ -190,6 +208,7 @@ private:
                 {"STAGE_5X", 0.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 85.0f}
             }
         });
@@ -208,6 +227,7 @@ private:
                 {"STAGE_5X", 1.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 100.0f}
             }
         });
@@ -226,6 +246,7 @@ private:
                 {"STAGE_5X", 1.0f},
                 {"STAGE_10X", 1.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 100.0f}
             }
         });
@@ -244,6 +265,7 @@ private:
                 {"STAGE_5X", 0.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 50.0f}
             }
         });
@@ -262,6 +284,7 @@ private:
                 {"STAGE_5X", 0.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 40.0f}
             }
         });
@@ -280,6 +303,7 @@ private:
                 {"STAGE_5X", 0.0f},
                 {"STAGE_10X", 0.0f},
                 {"AUTO_GAIN", 1.0f},
+                {"BANDS", 0.0f},
                 {"MIX", 60.0f}
             }
         });
@@ -297,21 +321,9 @@ private:
         }
     }
 
-    bool loadPresetFromFile(const juce::File& file)
-    {
-        auto xml = juce::XmlDocument::parse(file);
-        if (xml != nullptr && xml->hasTagName(state.state.getType()))
-        {
-            state.replaceState(juce::ValueTree::fromXml(*xml));
-            currentPresetName = file.getFileNameWithoutExtension();
-            return true;
-        }
-        return false;
-    }
-
     juce::AudioProcessorValueTreeState& state;
     juce::File userPresetDir;
     std::vector<FactoryPreset> factoryPresets;
-    std::vector<juce::File> userPresetFiles;
+    juce::SharedResourcePointer<PresetIndex> presetIndex;
     juce::String currentPresetName{"Init"};
 };
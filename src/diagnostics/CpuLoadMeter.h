@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CycleClock.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * CpuLoadMeter - Real-time load of one processor instance
+ *
+ * The audio thread brackets each block with begin() / end(). Load is the
+ * block's processing time over its real-time duration (1.0 = the block took
+ * as long as it lasts). The meter keeps a smoothed current value, the mean
+ * and peak since the last reset, a histogram for percentiles, and counts the
+ * blocks whose load went over the budget.
+ *
+ * Every statistic is a single-writer atomic, so getStats() can be called
+ * from any thread without locking. Values are individually consistent; a
+ * snapshot taken mid-block may mix this block's count with the last one's
+ * histogram, which a meter can live with.
+ */
+class CpuLoadMeter
+{
+public:
+    struct Stats
+    {
+        uint64_t blocks = 0;        // Blocks measured since the last reset
+        uint64_t overruns = 0;      // Blocks whose load exceeded the budget
+        float budget = 1.0f;
+        float current = 0.0f;      // Smoothed over about 300 ms of audio
+        float average = 0.0f;
+        float peak = 0.0f;
+        float p50 = 0.0f, p95 = 0.0f, p99 = 0.0f;   // Bin upper edges (0.5 % resolution)
+    };
+
+    /**
+     * Set the sample rate and clear the statistics. Call off the audio
+     * thread: the first call in a process calibrates the cycle counter.
+     */
+    void prepare(double sampleRate)
+    {
+        ticksPerSample = CycleClock::ticksPerSecond() / sampleRate;
+        secondsPerSample = 1.0 / sampleRate;
+        clear();
+        resetRequested.store(false, std::memory_order_relaxed);
+    }
+
+    /** Load (fraction of real time) above which a block counts as an overrun */
+    void setBudget(float fractionOfRealtime) { budget.store(fractionOfRealtime, std::memory_order_relaxed); }
+    float getBudget() const { return budget.load(std::memory_order_relaxed); }
+
+    /** Clear the statistics from any thread; the audio thread applies it on its next block */
+    void reset() { resetRequested.store(true, std::memory_order_release); }
+
+    uint64_t begin() const noexcept { return CycleClock::now(); }
+
+    void end(uint64_t startTicks, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || ticksPerSample <= 0.0)
+            return;
+
+        const uint64_t elapsed = CycleClock::now() - startTicks;
+
+        if (resetRequested.exchange(false, std::memory_order_acquire))
+            clear();
+
+        const double load = static_cast<double>(elapsed) / (ticksPerSample * numSamples);
+        const auto loadF = static_cast<float>(load);
+
+        const auto blocks = blockCount.load(std::memory_order_relaxed) + 1;
+        loadSum += load;
+
+        // One-pole smoothing scaled by block length, so the meter's speed
+        // doesn't depend on the host's buffer size
+        const float smoothing = static_cast<float>(std::min(1.0, numSamples * secondsPerSample / smoothingSeconds));
+        smoothedLoad += smoothing * (loadF - smoothedLoad);
+
+        const int bin = std::min(numBins - 1, static_cast<int>(load * binsPerUnit));
+        histogram[static_cast<size_t>(bin)].store(histogram[static_cast<size_t>(bin)].load(std::memory_order_relaxed) + 1,
+                                                  std::memory_order_relaxed);
+
+        if (loadF > budget.load(std::memory_order_relaxed))
+            overrunCount.store(overrunCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (loadF > peakLoad.load(std::memory_order_relaxed))
+            peakLoad.store(loadF, std::memory_order_relaxed);
+
+        currentLoad.store(smoothedLoad, std::memory_order_relaxed);
+        averageLoad.store(static_cast<float>(loadSum / static_cast<double>(blocks)), std::memory_order_relaxed);
+        blockCount.store(blocks, std::memory_order_release);
+    }
+
+    /** Snapshot of the statistics, from any thread */
+    Stats getStats() const
+    {
+        Stats stats;
+        stats.blocks = blockCount.load(std::memory_order_acquire);
+        stats.overruns = overrunCount.load(std::memory_order_relaxed);
+        stats.budget = budget.load(std::memory_order_relaxed);
+        stats.current = currentLoad.load(std::memory_order_relaxed);
+        stats.average = averageLoad.load(std::memory_order_relaxed);
+        stats.peak = peakLoad.load(std::memory_order_relaxed);
+
+        std::array<uint32_t, numBins> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+            total += counts[i] = histogram[i].load(std::memory_order_relaxed);
+
+        auto percentile = [&](double p)
+        {
+            const auto target = static_cast<uint64_t>(p * static_cast<double>(total));
+            uint64_t below = 0;
+            for (int i = 0; i < numBins; ++i)
+            {
+                below += counts[static_cast<size_t>(i)];
+                if (below > target)
+                    return std::min(stats.peak, static_cast<float>(i + 1) / binsPerUnit);
+            }
+            return stats.peak;
+        };
+
+        if (total > 0)
+        {
+            stats.p50 = percentile(0.50);
+            stats.p95 = percentile(0.95);
+            stats.p99 = percentile(0.99);
+        }
+
+        return stats;
+    }
+
+private:
+    static constexpr int binsPerUnit = 200;                // 0.5 % load per bin
+    static constexpr int numBins = 2 * binsPerUnit + 1;    // Up to 200 %, then one overflow bin
+    static constexpr double smoothingSeconds = 0.3;
+
+    void clear() noexcept
+    {
+        for (auto& count : histogram)
+            count.store(0, std::memory_order_relaxed);
+
+        loadSum = 0.0;
+        smoothedLoad = 0.0f;
+        overrunCount.store(0, std::memory_order_relaxed);
+        peakLoad.store(0.0f, std::memory_order_relaxed);
+        currentLoad.store(0.0f, std::memory_order_relaxed);
+        averageLoad.store(0.0f, std::memory_order_relaxed);
+        blockCount.store(0, std::memory_order_release);
+    }
+
+    // Audio thread only
+    double ticksPerSample = 0.0;
+    double secondsPerSample = 0.0;
+    double loadSum = 0.0;
+    float smoothedLoad = 0.0f;
+
+    // Published
+    std::atomic<uint64_t> blockCount{0};
+    std::atomic<uint64_t> overrunCount{0};
+    std::atomic<float> currentLoad{0.0f};
+    std::atomic<float> averageLoad{0.0f};
+    std::atomic<float> peakLoad{0.0f};
+    std::array<std::atomic<uint32_t>, numBins> histogram{};
+
+    std::atomic<float> budget{1.0f};
+    std::atomic<bool> resetRequested{false};
+};
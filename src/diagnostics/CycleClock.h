@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+  #define SANGUINOVA_CYCLECLOCK_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define SANGUINOVA_CYCLECLOCK_TSC 1
+#elif defined(__aarch64__)
+  #define SANGUINOVA_CYCLECLOCK_CNTVCT 1
+#endif
+
+/**
+ * CycleClock - Cheap, high-resolution timestamps for profiling the DSP
+ *
+ * Reads the CPU's time-stamp counter where there is one (x86 TSC, AArch64
+ * virtual counter) and falls back to std::chrono::steady_clock nanoseconds.
+ *
+ * TSC ticks are reference cycles at the nominal clock rather than core
+ * cycles, so they stay comparable across turbo states; ticksPerSecond()
+ * converts them to time. The AArch64 counter runs at a fixed, much lower
+ * rate (typically 24 MHz), so time single calls there over many blocks.
+ */
+namespace CycleClock
+{
+
+inline uint64_t now() noexcept
+{
+#if SANGUINOVA_CYCLECLOCK_TSC
+    return __rdtsc();
+#elif SANGUINOVA_CYCLECLOCK_CNTVCT
+    uint64_t ticks;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/** Which counter now() reads, for reports */
+inline const char* name() noexcept
+{
+#if SANGUINOVA_CYCLECLOCK_TSC
+    return "tsc";
+#elif SANGUINOVA_CYCLECLOCK_CNTVCT
+    return "cntvct";
+#else
+    return "steady_clock";
+#endif
+}
+
+/**
+ * Ticks per second. The TSC rate is measured once against steady_clock
+ * (the first call spins for about 50 ms); the others are known.
+ */
+inline double ticksPerSecond()
+{
+#if SANGUINOVA_CYCLECLOCK_TSC
+    static const double rate = []
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto wallStart = Clock::now();
+        const uint64_t tickStart = now();
+
+        while (Clock::now() - wallStart < std::chrono::milliseconds(50)) {}
+
+        const uint64_t tickEnd = now();
+        const std::chrono::duration<double> elapsed = Clock::now() - wallStart;
+        return static_cast<double>(tickEnd - tickStart) / elapsed.count();
+    }();
+    return rate;
+#elif SANGUINOVA_CYCLECLOCK_CNTVCT
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return static_cast<double>(frequency);
+#else
+    return 1.0e9;
+#endif
+}
+
+/** Smallest back-to-back now() difference, to subtract from short intervals */
+inline uint64_t overhead()
+{
+    static const uint64_t cost = []
+    {
+        uint64_t smallest = UINT64_MAX;
+        for (int i = 0; i < 1000; ++i)
+        {
+            const uint64_t start = now();
+            smallest = std::min(smallest, now() - start);
+        }
+        return smallest;
+    }();
+    return cost;
+}
+
+} // namespace CycleClock
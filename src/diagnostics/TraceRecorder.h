@@ -0,0 +1,227 @@
+#pragma once
+
+/**
+ * TraceRecorder - In-process event trace for profiling the audio thread
+ *
+ * Compiled in only with SANGUINOVA_ENABLE_TRACING (CMake option of the same
+ * name). Without it the SANGUINOVA_TRACE_* macros expand to nothing and
+ * this header declares nothing else, so call sites cost nothing.
+ *
+ * Begin/end events go into a fixed-capacity ring shared by every thread and
+ * every plugin instance in the process. Writing one is a fetch_add to claim
+ * a slot plus a handful of relaxed stores: no locks, no allocation. Each
+ * slot carries a sequence number, so a dump taken while threads keep
+ * writing skips the few slots being overwritten instead of reading them
+ * half-written. Once the ring is full the oldest events are overwritten.
+ *
+ * dumpAsync() writes the ring as Chrome trace JSON (chrome://tracing,
+ * ui.perfetto.dev) from a background thread.
+ *
+ *   SANGUINOVA_TRACE_SCOPE("name");                  // begin here, end at scope exit
+ *   SANGUINOVA_TRACE_BLOCK("name", numSamples);      // same, tagged with a block size
+ *
+ * Names must be string literals (only the pointer is stored).
+ */
+
+#if SANGUINOVA_ENABLE_TRACING
+
+#include "CycleClock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class TraceRecorder
+{
+public:
+    static constexpr int Capacity = 1 << 16;    // Events kept (about 10 s of a 64-sample chunk loop)
+
+    /** The process-wide recorder. Touch it once off the audio thread first (it calibrates the clock). */
+    static TraceRecorder& instance()
+    {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    ~TraceRecorder()
+    {
+        const std::lock_guard<std::mutex> lock(dumpMutex);
+        if (dumpThread.joinable())
+            dumpThread.join();
+    }
+
+    /** Append one event; phase is 'B' (begin) or 'E' (end), samples < 0 for none */
+    void record(const char* name, char phase, int samples) noexcept
+    {
+        const uint64_t index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots[index & (Capacity - 1)];
+
+        // Odd sequence while the fields change
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.timestamp.store(CycleClock::now(), std::memory_order_relaxed);
+        slot.samples.store(samples, std::memory_order_relaxed);
+        slot.thread.store(currentThreadId(), std::memory_order_relaxed);
+        slot.phase.store(phase, std::memory_order_relaxed);
+
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+    }
+
+    /**
+     * Write the ring to path on a background thread. Returns false if the
+     * previous dump is still running. Never call from the audio thread.
+     */
+    bool dumpAsync(std::string path)
+    {
+        const std::lock_guard<std::mutex> lock(dumpMutex);
+
+        if (dumping.load())
+            return false;
+
+        if (dumpThread.joinable())
+            dumpThread.join();
+
+        dumping.store(true);
+        dumpThread = std::thread([this, path = std::move(path)]
+        {
+            dump(path);
+            dumping.store(false);
+        });
+        return true;
+    }
+
+    /** Write the ring to path as Chrome trace JSON, on the calling thread */
+    bool dump(const std::string& path) const
+    {
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "w"), &std::fclose);
+        if (file == nullptr)
+            return false;
+
+        const uint64_t end = writeIndex.load(std::memory_order_acquire);
+        const uint64_t begin = end > Capacity ? end - Capacity : 0;
+        const double microsecondsPerTick = 1.0e6 / CycleClock::ticksPerSecond();
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file.get());
+
+        bool first = true;
+        for (uint64_t index = begin; index < end; ++index)
+        {
+            Event event;
+            if (! read(index, event))
+                continue;
+
+            const double timestamp = static_cast<double>(event.timestamp - origin) * microsecondsPerTick;
+
+            std::fprintf(file.get(), "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+                         first ? "" : ",\n", event.name, event.phase, timestamp, event.thread);
+
+            if (event.phase == 'B' && event.samples >= 0)
+                std::fprintf(file.get(), ",\"args\":{\"samples\":%d}", event.samples);
+
+            std::fputc('}', file.get());
+            first = false;
+        }
+
+        std::fputs("\n]}\n", file.get());
+        return std::ferror(file.get()) == 0;
+    }
+
+    /** Begin on construction, end on destruction */
+    class Scope
+    {
+    public:
+        explicit Scope(const char* eventName, int samples = -1) noexcept : name(eventName)
+        {
+            instance().record(name, 'B', samples);
+        }
+
+        ~Scope() { instance().record(name, 'E', -1); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+    };
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};     // 2 * index + 2 once complete, odd while written
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> timestamp{0};
+        std::atomic<int> samples{0};
+        std::atomic<uint32_t> thread{0};
+        std::atomic<char> phase{0};
+    };
+
+    struct Event
+    {
+        const char* name;
+        uint64_t timestamp;
+        int samples;
+        uint32_t thread;
+        char phase;
+    };
+
+    TraceRecorder() : slots(new Slot[Capacity]), origin(CycleClock::now())
+    {
+        CycleClock::ticksPerSecond();   // Calibrate here rather than in the first dump
+    }
+
+    /** Copy slot index out, or return false if it was overwritten or is mid-write */
+    bool read(uint64_t index, Event& event) const
+    {
+        const Slot& slot = slots[index & (Capacity - 1)];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence != 2 * index + 2)
+            return false;
+
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        event.samples = slot.samples.load(std::memory_order_relaxed);
+        event.thread = slot.thread.load(std::memory_order_relaxed);
+        event.phase = slot.phase.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == sequence && event.name != nullptr;
+    }
+
+    /** Small sequential ids, assigned on each thread's first event */
+    static uint32_t currentThreadId() noexcept
+    {
+        static std::atomic<uint32_t> nextId{1};
+        thread_local const uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> writeIndex{0};
+    const uint64_t origin;              // Timestamps are written relative to recorder creation
+
+    std::mutex dumpMutex;
+    std::thread dumpThread;
+    std::atomic<bool> dumping{false};
+};
+
+#define SANGUINOVA_TRACE_CONCAT_INNER(a, b) a##b
+#define SANGUINOVA_TRACE_CONCAT(a, b) SANGUINOVA_TRACE_CONCAT_INNER(a, b)
+
+#define SANGUINOVA_TRACE_SCOPE(name) \
+    const TraceRecorder::Scope SANGUINOVA_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define SANGUINOVA_TRACE_BLOCK(name, numSamples) \
+    const TraceRecorder::Scope SANGUINOVA_TRACE_CONCAT(traceScope, __LINE__)(name, numSamples)
+
+#else
+
+#define SANGUINOVA_TRACE_SCOPE(name) ((void) 0)
+#define SANGUINOVA_TRACE_BLOCK(name, numSamples) ((void) 0)
+
+#endif
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <cmath>
+#include <vector>
 #include <algorithm>
+#include "Simd.h"
+#include "DelayLine.h"
 
 /**
  * AutoGain - Intelligent Gain Compensation
@@ -9,132 +12,147 @@
  * Measures input/output envelopes and applies correction
  * so output loudness matches input loudness.
  *
- * Uses fast attack (prevent digital spikes) and medium release
- * (prevent volume fluttering).
+ * Works a block at a time: the mean square of every channel (stereo-linked,
+ * so the image doesn't shift) is summed with SIMD, then each envelope takes
+ * one attack-or-release step scaled to the block length. The gain glides
+ * linearly across the block towards sqrt(input / output energy).
+ *
+ * With look-ahead the wet signal is delayed while detection runs on the
+ * undelayed signal, so the gain moves ahead of the material it reacts to.
+ * The delay adds to the plugin's latency (see getLookahead()).
+ *
+ * FloatType (float or double) is the sample type; the envelopes use it too.
  */
-class AutoGain
+template <typename FloatType>
+class BasicAutoGain
 {
 public:
-    AutoGain()
-        : inputEnvelope(0.0f)
-        , outputEnvelope(0.0f)
-        , gainReduction(1.0f)
-        , smoothedGR(1.0f)
-        , sampleRate(44100.0f)
-    {
-        calculateCoefficients();
-    }
-
-    void prepare(float newSampleRate)
+    /**
+     * @param maximumLookahead Longest look-ahead setLookahead() will be given
+     */
+    void prepare(float newSampleRate, int numChannels, int maximumLookahead)
     {
         sampleRate = newSampleRate;
-        calculateCoefficients();
+        delays.resize(static_cast<size_t>(numChannels));
+        for (auto& delay : delays)
+            delay.prepare(maximumLookahead);
+
+        calculatedBlockSize = 0;
         reset();
     }
 
-    void reset()
+    /** Clear the envelopes and delays and start from initialGain */
+    void reset(FloatType initialGain = 1)
     {
-        inputEnvelope = 0.0f;
-        outputEnvelope = 0.0f;
-        gainReduction = 1.0f;
-        smoothedGR = 1.0f;
-    }
+        inputEnergy = 0;
+        outputEnergy = 0;
+        gain = initialGain;
 
-    /**
-     * Update the input envelope with a sample (call before processing)
-     */
-    void updateInputEnvelope(float sample)
-    {
-        float absSample = std::fabs(sample);
-        float alpha = (absSample > inputEnvelope) ? attackCoeff : releaseCoeff;
-        inputEnvelope = inputEnvelope + alpha * (absSample - inputEnvelope);
+        for (auto& delay : delays)
+            delay.reset();
     }
 
-    /**
-     * Update the output envelope with a sample (call after processing)
-     */
-    void updateOutputEnvelope(float sample)
+    /** Look-ahead in samples (0 = off) */
+    void setLookahead(int numSamples)
     {
-        float absSample = std::fabs(sample);
-        float alpha = (absSample > outputEnvelope) ? attackCoeff : releaseCoeff;
-        outputEnvelope = outputEnvelope + alpha * (absSample - outputEnvelope);
+        lookahead = numSamples;
+        for (auto& delay : delays)
+            delay.setDelay(static_cast<float>(numSamples));
     }
 
+    int getLookahead() const { return lookahead; }
+
     /**
-     * Calculate and return the gain reduction factor
-     * GR = E_in / E_out
+     * Measure one block and produce its gain ramp
+     * @param input numChannels dry buffers (the level to match)
+     * @param output numChannels wet buffers, delayed in place by the look-ahead
+     * @param gains numSamples per-sample gains for the (delayed) wet signal
      */
-    float getGainReduction()
+    void process(const FloatType* const* input, FloatType* const* output, int numChannels, int numSamples, FloatType* gains)
     {
-        // Avoid division by zero and limit extreme values
-        constexpr float epsilon = 1e-6f;
-        constexpr float minGR = 0.1f;   // -20dB max reduction
-        constexpr float maxGR = 5.0f;   // +14dB max boost
+        if (numSamples <= 0)
+            return;
 
-        if (outputEnvelope > epsilon)
-        {
-            gainReduction = inputEnvelope / outputEnvelope;
-            gainReduction = std::clamp(gainReduction, minGR, maxGR);
-        }
-        else
+        if (numSamples != calculatedBlockSize)
+            calculateCoefficients(numSamples);
+
+        FloatType inputSum = 0, outputSum = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            gainReduction = 1.0f;
+            inputSum += simd::sumOfSquares(input[ch], numSamples);
+            outputSum += simd::sumOfSquares(output[ch], numSamples);
         }
 
-        // Smooth the gain reduction to avoid sudden jumps
-        smoothedGR = smoothedGR + grSmoothCoeff * (gainReduction - smoothedGR);
+        const FloatType norm = FloatType(1) / static_cast<FloatType>(numSamples * std::max(1, numChannels));
+        inputEnergy = follow(inputEnergy, inputSum * norm);
+        outputEnergy = follow(outputEnergy, outputSum * norm);
 
-        return smoothedGR;
-    }
+        // Hold the gain through silence instead of snapping back to unity
+        FloatType target = gain;
+        if (outputEnergy > epsilon)
+            target = std::clamp(std::sqrt(inputEnergy / outputEnergy), minGain, maxGain);
 
-    /**
-     * Process a sample with auto-gain applied
-     * This is a convenience method that applies the current GR
-     */
-    float applySample(float sample)
-    {
-        return sample * smoothedGR;
-    }
+        const FloatType previous = gain;
+        gain += gainCoeff * (target - gain);
 
-    /**
-     * Update both envelopes with input/output pairs from a block
-     */
-    void processEnvelopes(const float* inputBuffer, const float* outputBuffer, int numSamples)
-    {
+        const FloatType step = (gain - previous) / static_cast<FloatType>(numSamples);
         for (int i = 0; i < numSamples; ++i)
+            gains[i] = previous + step * static_cast<FloatType>(i + 1);
+
+        if (lookahead > 0)
         {
-            updateInputEnvelope(inputBuffer[i]);
-            updateOutputEnvelope(outputBuffer[i]);
+            for (int ch = 0; ch < numChannels; ++ch)
+                delays[static_cast<size_t>(ch)].processBlock(output[ch], numSamples);
         }
     }
 
-    float getInputLevel() const { return inputEnvelope; }
-    float getOutputLevel() const { return outputEnvelope; }
-    float getCurrentGR() const { return smoothedGR; }
+    FloatType getInputLevel() const { return std::sqrt(inputEnergy); }
+    FloatType getOutputLevel() const { return std::sqrt(outputEnergy); }
+    FloatType getCurrentGain() const { return gain; }
 
 private:
-    void calculateCoefficients()
+    static constexpr FloatType epsilon = FloatType(1.0e-10);  // Mean square floor (-100 dBFS)
+    static constexpr FloatType minGain = FloatType(0.1);      // -20dB max reduction
+    static constexpr FloatType maxGain = FloatType(5.0);      // +14dB max boost
+
+    /** Attack when the level rises, release when it falls: one step per block */
+    FloatType follow(FloatType envelope, FloatType level) const
     {
-        // Attack: 1ms (fast to prevent digital spikes)
-        float attackTimeMs = 1.0f;
-        attackCoeff = 1.0f - std::exp(-1.0f / (sampleRate * attackTimeMs * 0.001f));
+        const FloatType coeff = level > envelope ? attackCoeff : releaseCoeff;
+        return envelope + coeff * (level - envelope);
+    }
+
+    void calculateCoefficients(int blockSize)
+    {
+        auto coefficient = [&](float timeMs)
+        {
+            return FloatType(1) - std::exp(-static_cast<FloatType>(blockSize) / FloatType(sampleRate * timeMs * 0.001f));
+        };
+
+        // Attack: 5ms (RMS detection already averages over the block)
+        attackCoeff = coefficient(5.0f);
 
         // Release: 100ms (medium to prevent fluttering)
-        float releaseTimeMs = 100.0f;
-        releaseCoeff = 1.0f - std::exp(-1.0f / (sampleRate * releaseTimeMs * 0.001f));
+        releaseCoeff = coefficient(100.0f);
+
+        // Gain smoothing: 50ms
+        gainCoeff = coefficient(50.0f);
 
-        // GR smoothing: 50ms
-        float grSmoothTimeMs = 50.0f;
-        grSmoothCoeff = 1.0f - std::exp(-1.0f / (sampleRate * grSmoothTimeMs * 0.001f));
+        calculatedBlockSize = blockSize;
     }
 
-    float inputEnvelope;
-    float outputEnvelope;
-    float gainReduction;
-    float smoothedGR;
+    FloatType inputEnergy = 0;
+    FloatType outputEnergy = 0;
+    FloatType gain = 1;
 
-    float sampleRate;
-    float attackCoeff;
-    float releaseCoeff;
-    float grSmoothCoeff;
+    float sampleRate = 44100.0f;
+    int calculatedBlockSize = 0;
+    FloatType attackCoeff = 0;
+    FloatType releaseCoeff = 0;
+    FloatType gainCoeff = 0;
+
+    int lookahead = 0;
+    std::vector<BasicDelayLine<FloatType>> delays;   // One per channel, for the look-ahead
 };
+
+using AutoGain = BasicAutoGain<float>;
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include "Simd.h"
+#include "SanguinovaEngine.h"
+#include "SVFFilter.h"
+#include "OnePole.h"
+#include "Oversampler.h"
+#include "IIROversampler.h"
+#include "Crossover.h"
+#include "../diagnostics/TraceRecorder.h"
+
+/**
+ * ChannelStrip - The wet signal path for up to MaxChannels channels
+ *
+ * Pre-filter -> oversampled distortion engine -> post-filter.
+ *
+ * In multiband mode a Linkwitz-Riley crossover runs first and each lane
+ * keeps one band (see setBands()). The caller feeds a channel to one lane
+ * per band and sums those lanes afterwards; every band then has its own
+ * engine, drive offset and oversampler, and the bands of a channel advance
+ * side by side in the vector instead of as separate chains.
+ *
+ * The serial recursions (SVF, OnePole, the Live mode's allpass cascade) are
+ * stored structure-of-arrays: each channel's state sits in one SIMD lane,
+ * so a single pass over channel-interleaved frames advances every channel.
+ * The engine stays planar, one per channel (SIMD over samples, or
+ * per-channel ADAA history). The FIR oversampler runs either way: planar
+ * (SIMD over taps) for a few lanes, over lanes once enough of them are in
+ * use that the whole vector pays (see laneFirMinChannels), so extra bands
+ * cost the FIR path next to nothing, as they do the IIR one.
+ *
+ * The chain is instantiated once per filter mode and oversampler (see
+ * processKernel()), and process() picks the instantiation from a table once
+ * per block, so no mode or factor checks remain inside the sample loops.
+ *
+ * Silent input on a fully decayed chain can only produce silence, so the
+ * strip then goes idle and skips every stage until signal returns.
+ *
+ * FloatType (float or double) is the sample type of the whole chain. A
+ * double strip holds half as many channels, since that is what fits in a
+ * vector.
+ */
+template <typename FloatType>
+class BasicChannelStrip
+{
+public:
+    using Vec = simd::Vec<FloatType>;
+    static constexpr int MaxChannels = Vec::size;
+    static constexpr int MaxBands = BasicCrossover<Vec>::MaxBands;
+
+    /**
+     * Lanes in use from which the FIR runs over lanes instead of per channel
+     * (see useLaneFir()). With half the vector or less, the per-channel
+     * path's tap-SIMD wins at 8x and 16x, so stereo alone stays planar.
+     */
+    static constexpr int laneFirMinChannels = MaxChannels / 2 + 1;
+
+    /** Input and state at or below this (-120 dB at the shaper's input) count as silence */
+    static constexpr float silenceThreshold = 1.0e-6f;
+
+    /**
+     * Allocate all scratch for blocks of up to maximumBlockSize samples
+     */
+    void prepare(double sampleRate, int maximumBlockSize)
+    {
+        const int maxBlockSize = std::max(1, maximumBlockSize);
+
+        crossover.prepare(static_cast<float>(sampleRate));
+        preFilter.prepare(static_cast<float>(sampleRate));
+        postFilter.prepare(static_cast<float>(sampleRate));
+        liveOversampler.prepare(maxBlockSize);
+        laneOversampler.prepare(maxBlockSize);
+
+        for (int ch = 0; ch < MaxChannels; ++ch)
+        {
+            oversamplers[ch].prepare(maxBlockSize);
+            engines[ch].reset();
+        }
+
+        // Same output either way (within 1e-7), so the table is used wherever it
+        // saves CPU. Enabling it builds the shared table, which must not happen
+        // on the audio thread.
+        for (auto& engine : engines)
+            engine.setLookupTable(BasicSanguinovaEngine<FloatType>::lookupTableIsFaster);
+
+        frames.assign(static_cast<size_t>(maxBlockSize * MaxChannels), FloatType(0));
+        planar.assign(static_cast<size_t>(maxBlockSize * BasicOversampler<FloatType>::MaxFactor * MaxChannels), FloatType(0));
+        idle = false;
+    }
+
+    void reset()
+    {
+        crossover.reset();
+        preFilter.reset();
+        postFilter.reset();
+        liveOversampler.reset();
+        laneOversampler.reset();
+
+        for (int ch = 0; ch < MaxChannels; ++ch)
+        {
+            oversamplers[ch].reset();
+            engines[ch].reset();
+        }
+
+        idle = false;
+    }
+
+    /**
+     * Pre-filter, engine and post-filter settings, shared by all channels.
+     * Changed values are reached by gliding across the next process() call;
+     * unchanged ones recompute nothing.
+     * @param bandDriveDb Optional drive offsets in dB, indexed by CrossoverBand
+     *                    (only applied with more than one band)
+     */
+    void setParameters(float color, float inputQ, float outputLpFreq, float driveDb, float stageMult,
+                       const float* bandDriveDb = nullptr)
+    {
+        preFilter.setParameters(color, inputQ);
+        postFilter.setFrequency(outputLpFreq);
+
+        const bool offsets = bandDriveDb != nullptr && crossover.getNumBands() > 1;
+        for (int ch = 0; ch < MaxChannels; ++ch)
+        {
+            const float offset = offsets ? bandDriveDb[static_cast<int>(laneBands[ch])] : 0.0f;
+            engines[ch].setParameters(driveDb + offset, stageMult);
+        }
+    }
+
+    /**
+     * Split into bands ahead of the pre-filter, one band per lane
+     * @param numBands 1 (full band, the default), 2 or 3
+     * @param bands MaxChannels entries: the band each lane keeps
+     */
+    void setBands(int numBands, const CrossoverBand* bands)
+    {
+        std::copy(bands, bands + MaxChannels, laneBands.begin());
+        crossover.setBands(numBands, bands);
+    }
+
+    int getNumBands() const { return crossover.getNumBands(); }
+
+    /** Crossover frequencies in Hz (two bands only use the low one) */
+    void setCrossover(float lowFrequency, float highFrequency)
+    {
+        crossover.setFrequencies(lowFrequency, highFrequency);
+    }
+
+    /**
+     * Select oversampling factor, quality and ADAA order.
+     * Only selects precomputed filters, so it is safe on the audio thread.
+     * @return true if anything changed (the latency may have too)
+     */
+    bool setAntiAliasing(int factor, bool live, int adaaOrder)
+    {
+        if (factor == oversamplingFactor && live == liveOversampling
+            && adaaOrder == engines[0].getAntiderivativeOrder())
+            return false;
+
+        // The path being switched to may hold stale state from its last use
+        if (live != liveOversampling)
+        {
+            liveOversampler.reset();
+            laneOversampler.reset();
+            for (auto& os : oversamplers)
+                os.reset();
+        }
+
+        oversamplingFactor = factor;
+        liveOversampling = live;
+        liveOversampler.setFactor(factor);
+        laneOversampler.setFactor(factor);
+
+        for (int ch = 0; ch < MaxChannels; ++ch)
+        {
+            oversamplers[ch].setFactor(factor);
+            engines[ch].setAntiderivativeOrder(adaaOrder);
+        }
+
+        // Column of the kernel table (the FIR factor as the oversampler rounded it)
+        kernelIndex = 0;
+        if (! live)
+            for (int f = oversamplers[0].getFactor(); f > 0; f >>= 1)
+                ++kernelIndex;
+
+        return true;
+    }
+
+    /** Group delay of the wet path in base-rate samples */
+    float getLatencyInSamples() const
+    {
+        // ADAA and its droop shelf delay by 1.5 or 2 samples at the oversampled rate
+        const float oversamplingLatency = liveOversampling ? liveOversampler.getLatencyInSamples()
+                                                           : oversamplers[0].getLatencyInSamples();
+        return oversamplingLatency + engines[0].getLatencyInSamples() / static_cast<float>(oversamplingFactor);
+    }
+
+    /**
+     * Run the wet path in place
+     * @param channels numChannels planar buffers (numChannels <= MaxChannels)
+     * @param numSamples Samples per channel, at most the prepared block size
+     * @param colorModulation Optional pre-filter cutoff per sample (Hz),
+     *                        overriding the color given to setParameters()
+     */
+    void process(FloatType* const* channels, int numChannels, int numSamples, SVFMode mode,
+                 const FloatType* colorModulation = nullptr)
+    {
+        // Everything ahead of the shaper is judged at the level the shaper
+        // sees (in its hottest lane), so heavy drive cannot lift a "silent"
+        // residue into earshot
+        FloatType inputGain = 1;
+        for (int ch = 0; ch < numChannels; ++ch)
+            inputGain = std::max(inputGain, engines[ch].getInputGain());
+
+        const float threshold = silenceThreshold / static_cast<float>(inputGain);
+        const bool silentInput = isSilent(channels, numChannels, numSamples, threshold);
+
+        if (silentInput && idle)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::fill(channels[ch], channels[ch] + numSamples, FloatType(0));
+            return;
+        }
+
+        idle = false;
+
+        interleave(channels, numChannels, frames.data(), numSamples);
+
+        // The mode and oversampler are resolved here, once per block
+        (this->*selectKernel(mode))(numChannels, numSamples, colorModulation);
+
+        deinterleave(frames.data(), channels, numChannels, numSamples);
+
+        // Go idle once the tails have died away. What is left is below the
+        // threshold, so clearing it now (and restarting from zero) cannot click.
+        if (silentInput && stateIsSilent(numChannels, threshold))
+        {
+            reset();
+            idle = true;
+        }
+    }
+
+private:
+    static bool isSilent(const FloatType* const* channels, int numChannels, int numSamples, float threshold)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            if (simd::peak(channels[ch], numSamples) > threshold)
+                return false;
+        return true;
+    }
+
+    /** Filter and oversampler histories; the engines only remember their last inputs */
+    bool stateIsSilent(int numChannels, float threshold) const
+    {
+        if (! crossover.isSilent(threshold) || ! preFilter.isSilent(threshold) || ! postFilter.isSilent(threshold))
+            return false;
+
+        if (liveOversampling)
+            return liveOversampler.isSilent(threshold);
+
+        if (laneFir)
+            return laneOversampler.isSilent(threshold);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            if (! oversamplers[ch].isSilent(threshold))
+                return false;
+        return true;
+    }
+
+    /**
+     * Planar channels -> frames of MaxChannels samples. Unused lanes are left
+     * alone: lanes never interact, and they start out zeroed by prepare().
+     */
+    static void interleave(const FloatType* const* channels, int numChannels, FloatType* dest, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            for (int ch = 0; ch < numChannels; ++ch)
+                dest[i * MaxChannels + ch] = channels[ch][i];
+    }
+
+    static void deinterleave(const FloatType* source, FloatType* const* channels, int numChannels, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[ch][i] = source[i * MaxChannels + ch];
+    }
+
+    /**
+     * One instantiation of the chain per filter mode and oversampler: Factor
+     * 0 is the Live (IIR) path, otherwise the FIR factor. Every inner loop
+     * below then runs with its mode and factor known at compile time.
+     */
+    template <SVFMode mode, int Factor>
+    void processKernel(int numChannels, int numSamples, const FloatType* colorModulation)
+    {
+        // 0. Crossover (multiband only) - every band of every channel per frame
+        if (crossover.getNumBands() > 1)
+        {
+            SANGUINOVA_TRACE_BLOCK("crossover", numSamples);
+            crossover.processBlock(frames.data(), numSamples);
+        }
+
+        // 1. Pre-Filter (SVF) - all channels per frame
+        {
+            SANGUINOVA_TRACE_BLOCK("preFilter", numSamples);
+            if (colorModulation != nullptr)
+                preFilter.template processBlock<mode>(frames.data(), colorModulation, numSamples);
+            else
+                preFilter.template processBlock<mode>(frames.data(), numSamples);
+        }
+
+        // 2. Distortion Engine with Oversampling (block kernel per oversampled chunk)
+        {
+            SANGUINOVA_TRACE_BLOCK("distortion", numSamples);
+            if constexpr (Factor == 0)
+            {
+                liveOversampler.processBlock(frames.data(), numSamples, [&](FloatType* data, int numFrames) {
+                    distortInterleaved(data, numChannels, numFrames);
+                });
+            }
+            else
+            {
+                if (useLaneFir(numChannels))
+                    laneOversampler.template processBlock<Factor>(frames.data(), numSamples, [&](FloatType* data, int numFrames) {
+                        distortInterleaved(data, numChannels, numFrames);
+                    });
+                else
+                    distortPlanar<Factor>(numChannels, numSamples);
+            }
+        }
+
+        // 3. Output 1-pole LowPass Filter (smooths harsh harmonics)
+        {
+            SANGUINOVA_TRACE_BLOCK("postFilter", numSamples);
+            postFilter.processBlock(frames.data(), numSamples);
+        }
+    }
+
+    using Kernel = void (BasicChannelStrip::*)(int, int, const FloatType*);
+
+    /** Dispatch table lookup: mode x (Live, then FIR 1x to 16x) */
+    Kernel selectKernel(SVFMode mode) const
+    {
+        static constexpr Kernel kernels[3][BasicOversampler<FloatType>::NumFactors + 1] = {
+            { &BasicChannelStrip::processKernel<SVFMode::LowPass, 0>, &BasicChannelStrip::processKernel<SVFMode::LowPass, 1>,
+              &BasicChannelStrip::processKernel<SVFMode::LowPass, 2>, &BasicChannelStrip::processKernel<SVFMode::LowPass, 4>,
+              &BasicChannelStrip::processKernel<SVFMode::LowPass, 8>, &BasicChannelStrip::processKernel<SVFMode::LowPass, 16> },
+            { &BasicChannelStrip::processKernel<SVFMode::HighPass, 0>, &BasicChannelStrip::processKernel<SVFMode::HighPass, 1>,
+              &BasicChannelStrip::processKernel<SVFMode::HighPass, 2>, &BasicChannelStrip::processKernel<SVFMode::HighPass, 4>,
+              &BasicChannelStrip::processKernel<SVFMode::HighPass, 8>, &BasicChannelStrip::processKernel<SVFMode::HighPass, 16> },
+            { &BasicChannelStrip::processKernel<SVFMode::BandPass, 0>, &BasicChannelStrip::processKernel<SVFMode::BandPass, 1>,
+              &BasicChannelStrip::processKernel<SVFMode::BandPass, 2>, &BasicChannelStrip::processKernel<SVFMode::BandPass, 4>,
+              &BasicChannelStrip::processKernel<SVFMode::BandPass, 8>, &BasicChannelStrip::processKernel<SVFMode::BandPass, 16> },
+        };
+
+        // Out-of-range modes fall back to LowPass, as in SVFFilter
+        const int modeIndex = mode == SVFMode::HighPass ? 1 : mode == SVFMode::BandPass ? 2 : 0;
+        return kernels[modeIndex][kernelIndex];
+    }
+
+    /**
+     * Pick the FIR layout for this many lanes. The one switched to may hold
+     * stale history from its last use, so it starts over from silence.
+     */
+    bool useLaneFir(int numChannels)
+    {
+        const bool lanes = numChannels >= laneFirMinChannels;
+        if (lanes != laneFir)
+        {
+            laneFir = lanes;
+            laneOversampler.reset();
+            for (auto& os : oversamplers)
+                os.reset();
+        }
+        return laneFir;
+    }
+
+    /** Engines run planar so each keeps its own ADAA history */
+    void distortInterleaved(FloatType* data, int numChannels, int numFrames)
+    {
+        std::array<FloatType*, MaxChannels> lanes;
+        for (int ch = 0; ch < numChannels; ++ch)
+            lanes[ch] = planar.data() + ch * numFrames;
+
+        deinterleave(data, lanes.data(), numChannels, numFrames);
+        for (int ch = 0; ch < numChannels; ++ch)
+            engines[ch].processBlock(lanes[ch], numFrames);
+        interleave(lanes.data(), numChannels, data, numFrames);
+    }
+
+    /** FIR path for a few lanes: already SIMD across taps, so each channel runs on its own */
+    template <int Factor>
+    void distortPlanar(int numChannels, int numSamples)
+    {
+        std::array<FloatType*, MaxChannels> lanes;
+        for (int ch = 0; ch < numChannels; ++ch)
+            lanes[ch] = planar.data() + ch * numSamples;
+
+        deinterleave(frames.data(), lanes.data(), numChannels, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            oversamplers[ch].template processBlock<Factor>(lanes[ch], numSamples, [&](FloatType* data, int count) {
+                engines[ch].processBlock(data, count);
+            });
+        }
+        interleave(lanes.data(), numChannels, frames.data(), numSamples);
+    }
+
+    BasicCrossover<Vec> crossover;
+    BasicSVFFilter<Vec> preFilter;
+    BasicOnePole<Vec> postFilter;   // 1-pole LPF for smoothing
+    BasicIIROversampler<Vec> liveOversampler;
+    BasicOversampler<Vec> laneOversampler;     // FIR over lanes, for laneFirMinChannels or more
+
+    std::array<BasicOversampler<FloatType>, MaxChannels> oversamplers;
+    std::array<BasicSanguinovaEngine<FloatType>, MaxChannels> engines;
+
+    std::array<CrossoverBand, MaxChannels> laneBands {};   // Band each lane keeps (multiband only)
+
+    int oversamplingFactor = 0;     // Currently applied factor (0 = not yet applied)
+    bool liveOversampling = false;  // Live (IIR) instead of linear-phase (FIR)
+    bool laneFir = false;           // FIR runs over lanes (laneOversampler) instead of planar
+    int kernelIndex = 3;            // selectKernel() column: 0 = Live, else 1 + log2(FIR factor)
+    bool idle = false;              // Silent and decayed: process() just outputs zeros
+
+    std::vector<FloatType> frames;  // Interleaved base-rate frames
+    std::vector<FloatType> planar;  // Per-channel scratch, up to MaxFactor x the block
+};
+
+using ChannelStrip = BasicChannelStrip<float>;
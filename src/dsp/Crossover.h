@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include "Simd.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/** Band a crossover lane carries, shared by every BasicCrossover instantiation */
+enum class CrossoverBand
+{
+    Low = 0,
+    Mid,
+    High
+};
+
+/**
+ * Crossover - Linkwitz-Riley band splitter with one band per lane
+ *
+ * SampleType is float or double, or a simd::Vec of either. Every lane gets
+ * the same input (one channel's signal) and is told which band to keep, so a
+ * single pass over interleaved frames splits every band of every channel
+ * side by side instead of running one filter chain per band.
+ *
+ * Each split is 4th-order Linkwitz-Riley: two cascaded Butterworth TPT SVF
+ * sections at the same cutoff. A section's output is a per-lane blend of its
+ * low-, band- and high-pass taps, which selects the band per lane while the
+ * coefficients stay shared:
+ *
+ *   Low:  LP4(low split)  then AP2(high split)
+ *   Mid:  HP4(low split)  then LP4(high split)
+ *   High: HP4(low split)  then HP4(high split)
+ *
+ * LP4 + HP4 of one split is the 2nd-order allpass AP2 at its frequency, so
+ * the low band passing through the high split's allpass keeps all three in
+ * phase: they sum to AP2(high) * AP2(low), flat in magnitude. With two bands
+ * only the low split runs, and Low + High is AP2(low).
+ *
+ * Frequency changes glide across the next processBlock(), as in SVFFilter.
+ */
+template <typename SampleType>
+class BasicCrossover
+{
+public:
+    using FloatType = simd::ScalarType<SampleType>;
+    static constexpr int MaxBands = 3;
+    static constexpr int Lanes = simd::lanes<SampleType>;
+
+    void prepare(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        for (auto& split : splits)
+        {
+            split.lastFrequency = -1.0f;
+            split.snapToTarget = true;
+        }
+
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& split : splits)
+            for (auto& section : split.sections)
+                section.s1 = section.s2 = FloatType(0);
+    }
+
+    /** True once every section's state has decayed to at most threshold in every lane */
+    bool isSilent(float threshold) const
+    {
+        for (const auto& split : splits)
+            for (const auto& section : split.sections)
+                if (simd::peak(section.s1) > threshold || simd::peak(section.s2) > threshold)
+                    return false;
+        return true;
+    }
+
+    /**
+     * Choose the band each lane keeps
+     * @param newNumBands 1 (processBlock() passes everything through), 2 or 3
+     * @param laneBands Lanes entries; with two bands, Mid is treated as High
+     */
+    void setBands(int newNumBands, const CrossoverBand* laneBands)
+    {
+        numBands = std::clamp(newNumBands, 1, MaxBands);
+
+        // Section output = cx * input + c1 * band-pass + c2 * low-pass
+        std::array<Taps, 2> lowSplit {}, highSplit {};
+
+        for (size_t lane = 0; lane < static_cast<size_t>(Lanes); ++lane)
+        {
+            auto band = laneBands[lane];
+            if (numBands == 2 && band == CrossoverBand::Mid)
+                band = CrossoverBand::High;
+
+            for (size_t s = 0; s < 2; ++s)
+            {
+                if (band == CrossoverBand::Low)
+                {
+                    setTap(lowSplit[s], lane, lowPass);
+                    setTap(highSplit[s], lane, s == 0 ? allPass : through);
+                }
+                else
+                {
+                    setTap(lowSplit[s], lane, highPass);
+                    setTap(highSplit[s], lane, band == CrossoverBand::Mid ? lowPass : highPass);
+                }
+            }
+        }
+
+        for (size_t s = 0; s < 2; ++s)
+        {
+            splits[0].sections[s].setTaps(lowSplit[s]);
+            splits[1].sections[s].setTaps(highSplit[s]);
+        }
+    }
+
+    int getNumBands() const { return numBands; }
+
+    /**
+     * Split frequencies in Hz. Two bands only use lowFrequency.
+     * The next processBlock() ramps from the current coefficients to these.
+     */
+    void setFrequencies(float lowFrequency, float highFrequency)
+    {
+        splits[0].setFrequency(lowFrequency, sampleRate);
+        splits[1].setFrequency(highFrequency, sampleRate);
+    }
+
+    /** Split a block of frames in place (nothing to do with a single band) */
+    void processBlock(FloatType* buffer, int numFrames)
+    {
+        if (numBands < 2 || numFrames <= 0)
+            return;
+
+        const bool ramping = splits[0].ramping || splits[1].ramping;
+
+        if (numBands == 2)
+            ramping ? processFrames<2, true>(buffer, numFrames) : processFrames<2, false>(buffer, numFrames);
+        else
+            ramping ? processFrames<3, true>(buffer, numFrames) : processFrames<3, false>(buffer, numFrames);
+    }
+
+private:
+    /** 1 / Q of a Butterworth section */
+    static constexpr FloatType k = FloatType(1.41421356237309504880);
+
+    struct Coefficients
+    {
+        FloatType a1 = 1, a2 = 0, a3 = 0;
+    };
+
+    /** Per-lane output blend (input, band-pass, low-pass weights) of one section */
+    using Taps = std::array<std::array<FloatType, Lanes>, 3>;
+    using Tap = std::array<FloatType, 3>;
+
+    static constexpr Tap lowPass { 0, 0, 1 };
+    static constexpr Tap highPass { 1, -k, -1 };
+    static constexpr Tap allPass { 1, -2 * k, 0 };
+    static constexpr Tap through { 1, 0, 0 };
+
+    static void setTap(Taps& taps, size_t lane, const Tap& tap)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            taps[i][lane] = tap[i];
+    }
+
+    /** One SVF section: state and per-lane output blend */
+    struct Section
+    {
+        void setTaps(const Taps& taps)
+        {
+            cx = simd::load<SampleType>(taps[0].data());
+            c1 = simd::load<SampleType>(taps[1].data());
+            c2 = simd::load<SampleType>(taps[2].data());
+        }
+
+        SampleType s1 = FloatType(0), s2 = FloatType(0);
+        SampleType cx = FloatType(1), c1 = FloatType(0), c2 = FloatType(0);
+    };
+
+    /** One Linkwitz-Riley split: two sections sharing a cutoff */
+    struct Split
+    {
+        void setFrequency(float frequency, float rate)
+        {
+            if (frequency == lastFrequency)
+                return;
+
+            lastFrequency = frequency;
+            frequency = std::fmax(20.0f, std::fmin(frequency, rate * 0.49f));
+
+            const FloatType g = std::tan(static_cast<FloatType>(M_PI) * FloatType(frequency) / FloatType(rate));
+            target.a1 = FloatType(1) / (FloatType(1) + g * (g + k));
+            target.a2 = g * target.a1;
+            target.a3 = g * target.a2;
+
+            if (snapToTarget)
+            {
+                current = target;
+                snapToTarget = false;
+            }
+            else
+            {
+                ramping = true;
+            }
+        }
+
+        std::array<Section, 2> sections;
+        Coefficients current, target;
+        float lastFrequency = -1.0f;
+        bool ramping = false;
+        bool snapToTarget = true;
+    };
+
+    /** TPT SVF step with the section's blend as output */
+    static SampleType tick(SampleType input, Section& section, const Coefficients& c)
+    {
+        const SampleType v3 = input - section.s2;
+        const SampleType v1 = c.a1 * section.s1 + c.a2 * v3;
+        const SampleType v2 = section.s2 + c.a2 * section.s1 + c.a3 * v3;
+
+        section.s1 = FloatType(2) * v1 - section.s1;
+        section.s2 = FloatType(2) * v2 - section.s2;
+
+        return simd::mulAdd(section.c2, v2, simd::mulAdd(section.c1, v1, section.cx * input));
+    }
+
+    template <int Bands, bool ramp>
+    void processFrames(FloatType* buffer, int numFrames)
+    {
+        constexpr int numSplits = Bands - 1;
+
+        // States, blends and coefficients in locals so the recursion never round-trips through memory
+        std::array<Section, 2 * numSplits> sections;
+        std::array<Coefficients, numSplits> coeffs, steps;
+
+        for (size_t s = 0; s < static_cast<size_t>(numSplits); ++s)
+        {
+            sections[2 * s] = splits[s].sections[0];
+            sections[2 * s + 1] = splits[s].sections[1];
+            coeffs[s] = splits[s].current;
+
+            // Linear glide that lands on the target at the last frame
+            if constexpr (ramp)
+            {
+                const FloatType scale = FloatType(1) / static_cast<FloatType>(numFrames);
+                steps[s].a1 = (splits[s].target.a1 - coeffs[s].a1) * scale;
+                steps[s].a2 = (splits[s].target.a2 - coeffs[s].a2) * scale;
+                steps[s].a3 = (splits[s].target.a3 - coeffs[s].a3) * scale;
+            }
+        }
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            SampleType x = simd::load<SampleType>(buffer + i * Lanes);
+
+            for (size_t s = 0; s < static_cast<size_t>(numSplits); ++s)
+            {
+                if constexpr (ramp)
+                {
+                    coeffs[s].a1 += steps[s].a1;
+                    coeffs[s].a2 += steps[s].a2;
+                    coeffs[s].a3 += steps[s].a3;
+                }
+
+                for (size_t n = 2 * s; n < 2 * s + 2; ++n)
+                    x = tick(x, sections[n], coeffs[s]);
+            }
+
+            simd::store(x, buffer + i * Lanes);
+        }
+
+        for (size_t s = 0; s < static_cast<size_t>(numSplits); ++s)
+        {
+            splits[s].sections[0] = sections[2 * s];
+            splits[s].sections[1] = sections[2 * s + 1];
+        }
+
+        // The splits that ran have landed on their targets; an unused one jumps there
+        for (auto& split : splits)
+        {
+            split.current = split.target;
+            split.ramping = false;
+        }
+    }
+
+    std::array<Split, MaxBands - 1> splits;   // Low split, then high split
+    float sampleRate = 44100.0f;
+    int numBands = 1;
+};
+
+using Crossover = BasicCrossover<float>;
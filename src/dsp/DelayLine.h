@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+/**
+ * DelayLine - Fractional delay that lines the dry signal up with the wet path
+ *
+ * A circular buffer provides the integer part; a first-order Thiran allpass
+ *
+ *     H(z) = (a + z^-1) / (1 + a * z^-1),  a = (1 - d) / (1 + d)
+ *
+ * provides the fraction d. Unlike interpolation, the allpass leaves the
+ * magnitude flat, so the dry signal keeps its top end. Its group delay is
+ * exactly d at DC and stays close to it well up the band when d is kept in
+ * [0.5, 1.5), so the split is chosen that way.
+ *
+ * FloatType (float or double) is the sample type.
+ */
+template <typename FloatType>
+class BasicDelayLine
+{
+public:
+    /**
+     * Allocate for delays of up to maximumDelay samples
+     */
+    void prepare(int maximumDelay)
+    {
+        int size = 1;
+        while (size < maximumDelay + 2)
+            size *= 2;
+
+        buffer.assign(static_cast<size_t>(size), FloatType(0));
+        mask = size - 1;
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), FloatType(0));
+        writeIndex = 0;
+        x1 = 0;
+        y1 = 0;
+    }
+
+    /**
+     * Set the delay in samples (fractions allowed). The history is kept, so
+     * a change reads from a new position rather than starting from silence.
+     */
+    void setDelay(float delayInSamples)
+    {
+        delayInSamples = std::clamp(delayInSamples, 0.0f, static_cast<float>(mask - 1));
+        if (delayInSamples == delay)
+            return;
+
+        delay = delayInSamples;
+        integerDelay = delay < 0.5f ? 0 : static_cast<int>(std::floor(delay - 0.5f));
+
+        const FloatType fraction = static_cast<FloatType>(delay) - static_cast<FloatType>(integerDelay);
+        coefficient = (FloatType(1) - fraction) / (FloatType(1) + fraction);
+    }
+
+    float getDelay() const { return delay; }
+
+    /**
+     * Delay a block in place. At zero delay the history is still written,
+     * so a later setDelay() has the right samples to read.
+     */
+    void processBlock(FloatType* data, int numSamples)
+    {
+        if (delay == 0.0f)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                buffer[static_cast<size_t>(writeIndex)] = data[i];
+                writeIndex = (writeIndex + 1) & mask;
+            }
+            return;
+        }
+
+        const FloatType a = coefficient;
+        FloatType xPrev = x1, yPrev = y1;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer[static_cast<size_t>(writeIndex)] = data[i];
+            const FloatType x = buffer[static_cast<size_t>((writeIndex - integerDelay) & mask)];
+            writeIndex = (writeIndex + 1) & mask;
+
+            // y[n] = a * x[n] + x[n-1] - a * y[n-1]
+            yPrev = a * (x - yPrev) + xPrev;
+            xPrev = x;
+            data[i] = yPrev;
+        }
+
+        x1 = xPrev;
+        y1 = yPrev;
+    }
+
+private:
+    std::vector<FloatType> buffer = std::vector<FloatType>(2, FloatType(0));
+    int mask = 1;
+    int writeIndex = 0;
+
+    float delay = 0.0f;
+    int integerDelay = 0;
+    FloatType coefficient = 1;  // Thiran allpass coefficient for the fraction
+    FloatType x1 = 0, y1 = 0;   // Allpass state
+};
+
+using DelayLine = BasicDelayLine<float>;
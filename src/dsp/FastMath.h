@@ -0,0 +1,97 @@
+#pragma once
+
+#include <type_traits>
+#include "Simd.h"
+
+/**
+ * FastMath - Bounded-error approximations for the hot DSP paths
+ *
+ * Every function is a template so the same algorithm runs on plain floats
+ * and on simd::Vec<float> (or double and simd::Vec<double>). Block kernels
+ * therefore produce identical results for their vector body and scalar tail.
+ */
+namespace FastMath
+{
+
+/**
+ * e^x with a relative error below 3e-7 over the clamped range [-87, 88].
+ *
+ * Cody-Waite range reduction to x = n*ln2 + f with |f| <= ln2/2, then a
+ * degree-6 polynomial for e^f and an exponent-bit construction of 2^n.
+ * Inputs outside the range saturate rather than producing inf/denormals.
+ *
+ * Double lanes get the same construction at double accuracy (relative error
+ * below 1e-15 over [-708, 709]): a two-part ln2 with more bits and a
+ * degree-12 Taylor polynomial, whose truncation error is below 1e-16 on
+ * |f| <= ln2/2.
+ */
+template <typename T>
+inline T exp(T x)
+{
+    if constexpr (std::is_same_v<simd::ScalarType<T>, double>)
+    {
+        x = simd::min(simd::max(x, T(-708.0)), T(709.0));
+
+        const T n = simd::roundNearest(x * T(1.4426950408889634));
+        T f = simd::mulAdd(n, T(-6.93145751953125e-1), x);
+        f = simd::mulAdd(n, T(-1.4286068203094173e-6), f);
+
+        // Horner on 1/k!, k = 12 down to 2
+        T p = T(2.08767569878681e-9);
+        p = simd::mulAdd(p, f, T(2.505210838544172e-8));
+        p = simd::mulAdd(p, f, T(2.755731922398589e-7));
+        p = simd::mulAdd(p, f, T(2.7557319223985893e-6));
+        p = simd::mulAdd(p, f, T(2.48015873015873e-5));
+        p = simd::mulAdd(p, f, T(1.984126984126984e-4));
+        p = simd::mulAdd(p, f, T(1.388888888888889e-3));
+        p = simd::mulAdd(p, f, T(8.333333333333333e-3));
+        p = simd::mulAdd(p, f, T(4.1666666666666664e-2));
+        p = simd::mulAdd(p, f, T(1.6666666666666666e-1));
+        p = simd::mulAdd(p, f, T(0.5));
+        p = simd::mulAdd(p * f, f, f + T(1.0));
+
+        return p * simd::pow2i(n);
+    }
+    else
+    {
+        x = simd::min(simd::max(x, T(-87.0f)), T(88.0f));
+
+        const T n = simd::roundNearest(x * T(1.44269504088896341f));
+        T f = simd::mulAdd(n, T(-0.693359375f), x);
+        f = simd::mulAdd(n, T(2.12194440e-4f), f);
+
+        T p = T(1.9875691500e-4f);
+        p = simd::mulAdd(p, f, T(1.3981999507e-3f));
+        p = simd::mulAdd(p, f, T(8.3334519073e-3f));
+        p = simd::mulAdd(p, f, T(4.1665795894e-2f));
+        p = simd::mulAdd(p, f, T(1.6666665459e-1f));
+        p = simd::mulAdd(p, f, T(5.0000001201e-1f));
+        p = simd::mulAdd(p * f, f, f + T(1.0f));
+
+        return p * simd::pow2i(n);
+    }
+}
+
+/**
+ * tan(pi * x) for x in [0, 0.5), relative error below 1e-6 (float rounding
+ * dominates; the approximant itself is good to 1.4e-8, which is what double
+ * lanes get).
+ *
+ * Arguments above 1/4 are reflected with tan(pi x) = 1 / tan(pi (1/2 - x)),
+ * so a [5/4] Pade approximant on [0, pi/4] covers the range. The reflection
+ * swaps numerator and denominator, leaving a single division.
+ */
+template <typename T>
+inline T tanPi(T x)
+{
+    const auto upper = simd::greaterThan(x, T(0.25f));
+    const T y = simd::select(upper, T(0.5f) - x, x) * T(3.14159265358979f);
+    const T y2 = y * y;
+
+    const T num = y * simd::mulAdd(y2, y2 - T(105.0f), T(945.0f));
+    const T den = simd::mulAdd(y2, simd::mulAdd(y2, T(15.0f), T(-420.0f)), T(945.0f));
+
+    return simd::select(upper, den, num) / simd::select(upper, num, den);
+}
+
+} // namespace FastMath
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "Simd.h"
+
+/**
+ * IIROversampler - Low-Latency 1x/2x/4x/8x/16x Oversampling ("Live" mode)
+ *
+ * Cascade of 2x polyphase half-band stages. Each stage splits its half-band
+ * lowpass into two parallel chains of first-order allpass sections running
+ * at the lower rate:
+ *
+ *     H(z) = 0.5 * (A0(z^2) + z^-1 * A1(z^2))
+ *
+ * so every allpass costs a single multiply. The first stage carries the
+ * steep transition band; later stages only have to reject images far above
+ * the audio band and get by with two to four sections.
+ *
+ * The filters are minimum phase: there is no pre-ringing and the group delay
+ * at DC is 3-5 base-rate samples instead of the FIR path's 31, for about a
+ * sixth of its multiplies at 4x. The price is phase shift towards Nyquist.
+ *
+ * Coefficients come from the elliptic half-band design used by Laurent de
+ * Soras' HIIR library (number of sections + normalized transition width).
+ *
+ * SampleType is float or double, or a simd::Vec of either to run one
+ * channel per lane (see ChannelStrip). Block data is then interleaved
+ * frames, and all sample counts below are frame counts.
+ */
+template <typename SampleType>
+class BasicIIROversampler
+{
+public:
+    static constexpr int MaxFactor = 16;
+    static constexpr int NumStages = 4;     // log2(MaxFactor)
+    static constexpr int MaxSections = 8;   // Allpass sections per stage
+
+    using FloatType = simd::ScalarType<SampleType>;
+
+    static constexpr int stride = simd::lanes<SampleType>;   // Scalars per frame
+
+    BasicIIROversampler()
+    {
+        // Sections / transition width per stage, from the base rate upwards.
+        // Stopband rejection is better than 100 dB for every stage.
+        static constexpr std::array<int, NumStages> numSections{ 8, 4, 3, 2 };
+        static constexpr std::array<double, NumStages> transitions{ 0.05, 0.255, 0.37, 0.43 };
+
+        for (int s = 0; s < NumStages; ++s)
+            stages[s].design(numSections[s], transitions[s]);
+
+        setFactor(4);
+    }
+
+    /**
+     * Select the oversampling factor (1, 2, 4, 8 or 16).
+     * Filter states are cleared when the factor actually changes.
+     */
+    void setFactor(int newFactor)
+    {
+        int newStages = 0;
+        while (newStages < NumStages && (1 << newStages) < newFactor)
+            ++newStages;
+
+        if (numActiveStages == newStages)
+            return;
+
+        numActiveStages = newStages;
+        factor = 1 << newStages;
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+
+    void reset()
+    {
+        for (auto& stage : stages)
+            stage.reset();
+    }
+
+    /** True once every allpass state of the active stages is at most threshold */
+    bool isSilent(float threshold) const
+    {
+        for (int s = 0; s < numActiveStages; ++s)
+            if (! stages[s].isSilent(threshold))
+                return false;
+        return true;
+    }
+
+    /**
+     * Round-trip group delay at DC in base-rate samples.
+     * Each stage contributes the DC delay of its allpass sections, scaled by
+     * the rate it runs at; the downsampler decimates on the newest sample of
+     * each pair, which cancels the half-sample offset of the odd branch.
+     */
+    float getLatencyInSamples() const
+    {
+        float latency = 0.0f;
+        for (int s = 0; s < numActiveStages; ++s)
+            latency += stages[s].dcDelay / static_cast<float>(1 << s);
+        return latency;
+    }
+
+    /**
+     * Upsample a block of base-rate samples
+     * @param input numSamples base-rate samples
+     * @param output numSamples * getFactor() oversampled samples
+     */
+    void upsampleBlock(const FloatType* input, FloatType* output, int numSamples)
+    {
+        // Each stage expands in place towards the front of the output: the
+        // source sits at the tail, and a written pair never overtakes an
+        // unread source sample.
+        const int total = numSamples * factor;
+        std::copy(input, input + numSamples * stride, output + (total - numSamples) * stride);
+
+        for (int s = 0, length = numSamples; s < numActiveStages; ++s, length *= 2)
+            stages[s].upsample(output + (total - length) * stride, output + (total - 2 * length) * stride, length);
+    }
+
+    /**
+     * Downsample a block of oversampled samples
+     * @param input numSamples * getFactor() oversampled samples
+     * @param output numSamples base-rate samples
+     */
+    void downsampleBlock(const FloatType* input, FloatType* output, int numSamples)
+    {
+        if (factor == 1)
+        {
+            std::copy(input, input + numSamples * stride, output);
+            return;
+        }
+
+        // Intermediate rates are collapsed in place in the stage scratch
+        const int maxChunk = static_cast<int>(stageBuffer.size()) / (MaxFactor / 2 * stride);
+
+        for (int start = 0; start < numSamples; start += maxChunk)
+        {
+            const int chunk = std::min(maxChunk, numSamples - start);
+            const FloatType* source = input + start * factor * stride;
+
+            for (int s = numActiveStages - 1, length = chunk * factor / 2; s >= 0; --s, length /= 2)
+            {
+                FloatType* destination = (s == 0) ? output + start * stride : stageBuffer.data();
+                stages[s].downsample(source, destination, length);
+                source = destination;
+            }
+        }
+    }
+
+    /**
+     * Process a sample through oversampling with a waveshaper function
+     * @param input Input sample
+     * @param processor Lambda/function that processes each oversampled sample
+     * @return Downsampled output
+     */
+    template<typename ProcessFunc>
+    SampleType process(SampleType input, ProcessFunc processor)
+    {
+        std::array<FloatType, MaxFactor * stride> upsampled;
+        std::array<FloatType, stride> frame;
+        simd::store(input, frame.data());
+        upsampleBlock(frame.data(), upsampled.data(), 1);
+
+        for (int i = 0; i < factor; ++i)
+            simd::store(processor(simd::load<SampleType>(upsampled.data() + i * stride)), upsampled.data() + i * stride);
+
+        downsampleBlock(upsampled.data(), frame.data(), 1);
+        return simd::load<SampleType>(frame.data());
+    }
+
+    /**
+     * Allocate the oversampled scratch used by processBlock()
+     * Sized for MaxFactor so factor changes never reallocate.
+     * @param maximumBlockSize Largest number of base-rate samples per call
+     */
+    void prepare(int maximumBlockSize)
+    {
+        oversampledBlock.assign(static_cast<size_t>(std::max(1, maximumBlockSize) * MaxFactor * stride), FloatType(0));
+        stageBuffer.assign(static_cast<size_t>(std::max(1, maximumBlockSize) * MaxFactor / 2 * stride), FloatType(0));
+        reset();
+    }
+
+    /**
+     * Process a block through oversampling with a block-level waveshaper
+     * @param buffer Base-rate samples, processed in place
+     * @param numSamples Number of base-rate samples
+     * @param processor Callable (FloatType* data, int numOversampledFrames)
+     *                  applied once per oversampled sub-block
+     */
+    template<typename BlockFunc>
+    void processBlock(FloatType* buffer, int numSamples, BlockFunc&& processor)
+    {
+        const int maxChunk = static_cast<int>(oversampledBlock.size()) / (MaxFactor * stride);
+
+        for (int start = 0; start < numSamples; start += maxChunk)
+        {
+            const int chunk = std::min(maxChunk, numSamples - start);
+            FloatType* os = oversampledBlock.data();
+
+            upsampleBlock(buffer + start * stride, os, chunk);
+            processor(os, chunk * factor);
+            downsampleBlock(os, buffer + start * stride, chunk);
+        }
+    }
+
+private:
+    /**
+     * One 2x half-band stage. Sections alternate between the two branches:
+     * even indices form A0, odd indices A1. Each section is
+     * (c + z^-1) / (1 + c * z^-1) at the stage's lower rate.
+     */
+    struct HalfBandStage
+    {
+        std::array<FloatType, MaxSections> coeffs{};
+        int numSections = 0;
+        float dcDelay = 0.0f;       // Round-trip DC group delay at the stage's input rate
+
+        // Allpass states (previous input / output) for each direction
+        std::array<SampleType, MaxSections> upX, upY, downX, downY;
+
+        void reset()
+        {
+            upX.fill(FloatType(0));
+            upY.fill(FloatType(0));
+            downX.fill(FloatType(0));
+            downY.fill(FloatType(0));
+        }
+
+        bool isSilent(float threshold) const
+        {
+            for (int i = 0; i < numSections; ++i)
+                if (std::max({ simd::peak(upX[i]), simd::peak(upY[i]), simd::peak(downX[i]), simd::peak(downY[i]) }) > threshold)
+                    return false;
+            return true;
+        }
+
+        /**
+         * in: numSamples low-rate samples, out: 2 * numSamples high-rate
+         * samples. out may alias in as long as out + numSamples <= in.
+         */
+        void upsample(const FloatType* in, FloatType* out, int numSamples)
+        {
+            withSections([&](auto sections) { upsampleKernel<decltype(sections)::value>(in, out, numSamples); });
+        }
+
+        /** in: 2 * numSamples high-rate samples, out: numSamples (may alias in) */
+        void downsample(const FloatType* in, FloatType* out, int numSamples)
+        {
+            withSections([&](auto sections) { downsampleKernel<decltype(sections)::value>(in, out, numSamples); });
+        }
+
+        /** Map the runtime section count onto a compile-time constant */
+        template <typename Func>
+        void withSections(Func&& func) const
+        {
+            switch (numSections)
+            {
+                case 1:  func(std::integral_constant<int, 1>{}); break;
+                case 2:  func(std::integral_constant<int, 2>{}); break;
+                case 3:  func(std::integral_constant<int, 3>{}); break;
+                case 4:  func(std::integral_constant<int, 4>{}); break;
+                case 5:  func(std::integral_constant<int, 5>{}); break;
+                case 6:  func(std::integral_constant<int, 6>{}); break;
+                case 7:  func(std::integral_constant<int, 7>{}); break;
+                default: func(std::integral_constant<int, 8>{}); break;
+            }
+        }
+
+        /**
+         * Run both branches for one low-rate sample. With the section count
+         * fixed at compile time the loop unrolls and every state stays in a
+         * register; the two branches interleave to hide the add latency.
+         */
+        template <int N>
+        static void allpassPair(SampleType& path0, SampleType& path1, const FloatType* c, SampleType* x1, SampleType* y1)
+        {
+            for (int i = 0; i < N; ++i)
+            {
+                SampleType& path = (i % 2 == 0) ? path0 : path1;
+                // Only c * y1 sits on the feedback path; the rest is feed-forward
+                const SampleType y = (c[i] * path + x1[i]) - c[i] * y1[i];
+                x1[i] = path;
+                y1[i] = y;
+                path = y;
+            }
+        }
+
+        template <int N>
+        void upsampleKernel(const FloatType* in, FloatType* out, int numSamples)
+        {
+            std::array<FloatType, N> c;
+            std::array<SampleType, N> x1, y1;
+            std::copy(coeffs.begin(), coeffs.begin() + N, c.begin());
+            std::copy(upX.begin(), upX.begin() + N, x1.begin());
+            std::copy(upY.begin(), upY.begin() + N, y1.begin());
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                SampleType path0 = simd::load<SampleType>(in + i * stride), path1 = path0;
+                allpassPair<N>(path0, path1, c.data(), x1.data(), y1.data());
+                simd::store(path0, out + 2 * i * stride);
+                simd::store(path1, out + (2 * i + 1) * stride);
+            }
+
+            std::copy(x1.begin(), x1.end(), upX.begin());
+            std::copy(y1.begin(), y1.end(), upY.begin());
+        }
+
+        template <int N>
+        void downsampleKernel(const FloatType* in, FloatType* out, int numSamples)
+        {
+            std::array<FloatType, N> c;
+            std::array<SampleType, N> x1, y1;
+            std::copy(coeffs.begin(), coeffs.begin() + N, c.begin());
+            std::copy(downX.begin(), downX.begin() + N, x1.begin());
+            std::copy(downY.begin(), downY.begin() + N, y1.begin());
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // Decimate on the newer sample of each pair (A0); the older one feeds A1
+                SampleType path0 = simd::load<SampleType>(in + (2 * i + 1) * stride);
+                SampleType path1 = simd::load<SampleType>(in + 2 * i * stride);
+                allpassPair<N>(path0, path1, c.data(), x1.data(), y1.data());
+                simd::store(FloatType(0.5) * (path0 + path1), out + i * stride);
+            }
+
+            std::copy(x1.begin(), x1.end(), downX.begin());
+            std::copy(y1.begin(), y1.end(), downY.begin());
+        }
+
+        /**
+         * Elliptic half-band design for a given section count and transition
+         * width (normalized to the stage's output rate, centred on fs/4).
+         */
+        void design(int sections, double transition)
+        {
+            constexpr double pi = 3.14159265358979323846;
+
+            numSections = std::min(sections, MaxSections);
+            const int order = 2 * numSections + 1;
+
+            // Elliptic modulus k and nome q for the requested transition
+            double k = std::tan((1.0 - 2.0 * transition) * pi / 4.0);
+            k *= k;
+            const double kRoot = std::pow(1.0 - k * k, 0.25);
+            const double e = 0.5 * (1.0 - kRoot) / (1.0 + kRoot);
+            const double e4 = e * e * e * e;
+            const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+            double delay = 0.0;
+            for (int index = 0; index < numSections; ++index)
+            {
+                const int c = index + 1;
+
+                // Theta-function series for the section's pole position
+                double num = 0.0;
+                double term = 0.0;
+                int i = 0;
+                do
+                {
+                    term = std::pow(q, i * (i + 1)) * std::sin((2 * i + 1) * c * pi / order);
+                    num += (i % 2 == 0) ? term : -term;
+                    ++i;
+                } while (std::fabs(term) > 1e-100);
+
+                double den = 0.0;
+                i = 1;
+                do
+                {
+                    term = std::pow(q, i * i) * std::cos(2 * i * c * pi / order);
+                    den += (i % 2 == 0) ? term : -term;
+                    ++i;
+                } while (std::fabs(term) > 1e-100);
+
+                const double ww = num * std::pow(q, 0.25) / (den + 0.5);
+                const double wwSq = ww * ww;
+                const double x = std::sqrt((1.0 - wwSq * k) * (1.0 - wwSq / k)) / (1.0 + wwSq);
+                const double coeff = (1.0 - x) / (1.0 + x);
+
+                coeffs[index] = static_cast<FloatType>(coeff);
+
+                // DC group delay of one section at the lower rate
+                delay += (1.0 - coeff) / (1.0 + coeff);
+            }
+
+            dcDelay = static_cast<float>(delay);
+        }
+    };
+
+    std::array<HalfBandStage, NumStages> stages;    // [0] runs at the base rate
+    int numActiveStages = -1;
+    int factor = 1;
+
+    std::vector<FloatType> oversampledBlock = std::vector<FloatType>(MaxFactor * stride, FloatType(0));
+    std::vector<FloatType> stageBuffer = std::vector<FloatType>(MaxFactor / 2 * stride, FloatType(0));
+};
+
+using IIROversampler = BasicIIROversampler<float>;
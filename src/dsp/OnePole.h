@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cmath>
+#include <algorithm>
+#include "Simd.h"
 
 /**
  * OnePole - Simple 1-pole Low Pass Filter
@@ -9,43 +11,116 @@
  * Provides a gentle 6dB/octave rolloff.
  *
  * Transfer function: H(z) = g / (1 - (1-g)z^-1)
+ *
+ * SampleType is float or double, or a simd::Vec of either for one channel
+ * per lane (interleaved block data, shared coefficient of the scalar type).
+ *
+ * The coefficient is only recomputed when the frequency changes, and
+ * processBlock() glides to it per sample.
  */
-class OnePole
+template <typename SampleType>
+class BasicOnePole
 {
 public:
-    OnePole() = default;
+    using FloatType = simd::ScalarType<SampleType>;
+
+    BasicOnePole() = default;
 
     void prepare(float sampleRate)
     {
         fs = sampleRate;
+
+        // Force the next setFrequency() to recompute and jump straight there
+        lastFrequency = -1.0f;
+        snapToTarget = true;
         reset();
     }
 
     void reset()
     {
-        z1 = 0.0f;
+        z1 = FloatType(0);
     }
 
+    /** True once the state has decayed to at most threshold in every lane */
+    bool isSilent(float threshold) const
+    {
+        return simd::peak(z1) <= threshold;
+    }
+
+    /** The next processBlock() ramps from the current coefficient to this one */
     void setFrequency(float frequency)
     {
+        // Static controls cost a compare, not an exp()
+        if (frequency == lastFrequency)
+            return;
+
+        lastFrequency = frequency;
+
         // Clamp frequency to valid range
         frequency = std::max(20.0f, std::min(frequency, fs * 0.49f));
 
         // Calculate coefficient using exact formula for 1-pole LPF
         // g = 1 - exp(-2 * pi * fc / fs)
-        float w = 2.0f * 3.14159265359f * frequency / fs;
-        g = 1.0f - std::exp(-w);
+        const FloatType w = FloatType(2.0f * 3.14159265359f) * FloatType(frequency) / FloatType(fs);
+        targetG = FloatType(1) - std::exp(-w);
+
+        if (snapToTarget)
+        {
+            g = targetG;
+            snapToTarget = false;
+        }
     }
 
-    float processSample(float input)
+    SampleType processSample(SampleType input)
     {
+        g = targetG;
+
         // Simple 1-pole LPF: y[n] = y[n-1] + g * (x[n] - y[n-1])
         z1 = z1 + g * (input - z1);
         return z1;
     }
 
+    /**
+     * Process a block of frames in place
+     * The state lives in a register for the whole loop.
+     */
+    void processBlock(FloatType* buffer, int numFrames)
+    {
+        if (g != targetG)
+            processBlock<true>(buffer, numFrames);
+        else
+            processBlock<false>(buffer, numFrames);
+    }
+
 private:
+    template <bool ramp>
+    void processBlock(FloatType* buffer, int numFrames)
+    {
+        constexpr int stride = simd::lanes<SampleType>;
+
+        // Linear glide that lands on the target at the last frame
+        FloatType coeff = g;
+        const FloatType step = ramp ? (targetG - g) / static_cast<FloatType>(std::max(1, numFrames)) : FloatType(0);
+
+        SampleType state = z1;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if constexpr (ramp)
+                coeff += step;
+
+            state = state + coeff * (simd::load<SampleType>(buffer + i * stride) - state);
+            simd::store(state, buffer + i * stride);
+        }
+        z1 = state;
+        g = targetG;
+    }
+
     float fs = 44100.0f;
-    float g = 1.0f;      // Filter coefficient
-    float z1 = 0.0f;     // State variable
+    FloatType g = 1;         // Filter coefficient
+    FloatType targetG = 1;   // Coefficient g glides to
+    float lastFrequency = -1.0f;
+    bool snapToTarget = true;
+    SampleType z1 = FloatType(0);   // State variable (one per lane)
 };
+
+using OnePole = BasicOnePole<float>;
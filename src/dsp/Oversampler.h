@@ -2,96 +2,210 @@
 
 #include <cmath>
 #include <array>
+#include <vector>
+#include <type_traits>
 #include <algorithm>
+#include "Simd.h"
 
 /**
- * Oversampler - 4x Oversampling for Anti-Aliasing
+ * Oversampler - Selectable 1x/2x/4x/8x/16x Oversampling for Anti-Aliasing
  *
- * Uses polyphase FIR filter for efficient up/downsampling.
- * Critical for preventing aliasing in nonlinear distortion.
+ * Polyphase FIR interpolator/decimator built from one linear-phase
+ * Kaiser-windowed sinc prototype per factor (cutoff 0.22 of the base rate).
+ * Each factor has its own design (see designs): higher factors fold more
+ * image bands back into the audio band, so they get a deeper stopband and
+ * the longer branches that keep its transition band as narrow.
+ *
+ * - Upsampling never touches the zero-stuffed samples: each output phase is
+ *   a dot product of the input history with that phase's coefficients.
+ * - Histories are mirrored (stored twice, back to back) so every dot product
+ *   reads one contiguous window without any index wrapping.
+ * - The decimator exploits the prototype's symmetry and folds the window,
+ *   halving its multiplies.
+ *
+ * Each prototype has odd length factor * (filterOrder(factor) - 1) + 1, so
+ * the round-trip group delay is exactly filterOrder(factor) - 1 base-rate
+ * samples. All coefficient sets and histories are allocated up front, so
+ * setFactor() is safe to call from the audio thread.
+ *
+ * The kernels are instantiated per factor. The runtime entry points pick
+ * one with a single switch per call; callers that already know the factor
+ * (see ChannelStrip) call the templated overloads directly.
+ *
+ * FloatType (float or double) is the coefficient type; the prototype is
+ * always designed in double and rounded once. SampleType is FloatType, or a
+ * simd::Vec of it to run one channel per lane like BasicIIROversampler. The
+ * planar kernels are SIMD over taps; the lane kernels are SIMD over
+ * channels instead, so every lane in use comes for free and none of the
+ * horizontal sums remain. Block data is then interleaved frames, and all
+ * sample counts below are frame counts.
  */
-class Oversampler
+template <typename SampleType>
+class BasicOversampler
 {
 public:
-    static constexpr int Factor = 4;
-    static constexpr int FilterOrder = 32;  // FIR filter taps
-    static constexpr int HalfOrder = FilterOrder / 2;
+    using FloatType = simd::ScalarType<SampleType>;
+
+    static constexpr int stride = simd::lanes<SampleType>;   // Scalars per frame
 
-    Oversampler()
+    static constexpr int MaxFactor = 16;
+    static constexpr int NumFactors = 5;    // 1x, 2x, 4x, 8x, 16x
+
+    /** Prototype design for one factor */
+    struct Design
     {
-        initializeFilter();
+        int filterOrder;    // Taps per polyphase branch
+        double beta;        // Kaiser window beta (sets the stopband depth)
+    };
+
+    /**
+     * Indexed by log2(factor); [0] is the 1x bypass. 2x and 4x keep the
+     * original 32-tap, beta 7 (~70 dB) design. 8x folds enough image bands
+     * back to need beta 8 (~80 dB); 16x needs beta 10 (~100 dB), and the
+     * longer branch keeps its wider main lobe inside the same transition band.
+     */
+    static constexpr Design designs[NumFactors] = { { 0, 0.0 }, { 32, 7.0 }, { 32, 7.0 }, { 32, 8.0 }, { 48, 10.0 } };
+
+    static constexpr int filterOrder(int overFactor) { return designs[factorIndex(overFactor)].filterOrder; }
+
+    static constexpr int MaxFilterOrder = 48;
+    static constexpr int MaxDecimatorHistory = MaxFactor * MaxFilterOrder;  // Prototype plus one frame
+
+    BasicOversampler()
+    {
+        static_assert(longestDesign() == MaxFilterOrder, "Histories and branches are sized for MaxFilterOrder");
+
+        for (int index = 1; index < NumFactors; ++index)
+            initializeFilter(filterSets[index], 1 << index);
+
+        setFactor(4);
+    }
+
+    /**
+     * Select the oversampling factor (1, 2, 4, 8 or 16).
+     * Histories are cleared when the factor actually changes.
+     */
+    void setFactor(int newFactor)
+    {
+        int index = 0;
+        while (index < NumFactors - 1 && (1 << index) < newFactor)
+            ++index;
+
+        if (factor == (1 << index))
+            return;
+
+        factor = 1 << index;
         reset();
     }
 
+    int getFactor() const { return factor; }
+
     void reset()
     {
-        std::fill(upsampleBuffer.begin(), upsampleBuffer.end(), 0.0f);
-        std::fill(downsampleBuffer.begin(), downsampleBuffer.end(), 0.0f);
+        std::fill(upsampleHistory.begin(), upsampleHistory.end(), FloatType(0));
+        std::fill(downsampleHistory.begin(), downsampleHistory.end(), FloatType(0));
         upsampleIndex = 0;
         downsampleIndex = 0;
     }
 
+    /** True once every sample in both filter histories is at most threshold */
+    bool isSilent(float threshold) const
+    {
+        return simd::peak(upsampleHistory.data(), filterOrder(factor) * stride) <= threshold
+            && simd::peak(downsampleHistory.data(), factor * filterOrder(factor) * stride) <= threshold;
+    }
+
     /**
-     * Upsample a single input sample to 4 output samples
-     * @param input Single input sample
-     * @param output Array of 4 upsampled samples
+     * Round-trip (upsample + downsample) group delay in base-rate samples
      */
-    void upsample(float input, std::array<float, Factor>& output)
+    float getLatencyInSamples() const
     {
-        // Insert input with zero-stuffing
-        upsampleBuffer[upsampleIndex] = input * Factor;  // Compensate for energy loss
+        return factor > 1 ? static_cast<float>(filterOrder(factor) - 1) : 0.0f;
+    }
 
-        // Generate 4 output samples using polyphase decomposition
-        for (int phase = 0; phase < Factor; ++phase)
-        {
-            float sum = 0.0f;
-            for (int tap = 0; tap < FilterOrder; ++tap)
-            {
-                int bufIdx = (upsampleIndex - tap + FilterOrder) % FilterOrder;
-                int coeffIdx = tap * Factor + phase;
-                if (coeffIdx < FilterOrder * Factor)
-                {
-                    sum += upsampleBuffer[bufIdx] * getFilterCoeff(coeffIdx);
-                }
-            }
-            output[phase] = sum;
-        }
+    /**
+     * Upsample a block of base-rate samples
+     * @param input numSamples base-rate samples
+     * @param output numSamples * getFactor() oversampled samples
+     */
+    void upsampleBlock(const FloatType* input, FloatType* output, int numSamples)
+    {
+        withFactor([&](auto f) { upsampleBlock<decltype(f)::value>(input, output, numSamples); });
+    }
 
-        upsampleIndex = (upsampleIndex + 1) % FilterOrder;
+    /**
+     * Downsample a block of oversampled samples
+     * @param input numSamples * getFactor() oversampled samples
+     * @param output numSamples base-rate samples
+     */
+    void downsampleBlock(const FloatType* input, FloatType* output, int numSamples)
+    {
+        withFactor([&](auto f) { downsampleBlock<decltype(f)::value>(input, output, numSamples); });
     }
 
     /**
-     * Downsample 4 input samples to 1 output sample
-     * @param input Array of 4 oversampled samples
-     * @return Single downsampled output
+     * upsampleBlock() for a factor fixed at compile time, which must be the
+     * one selected by setFactor(). The phase loop and every window length
+     * are then constants, so the kernel unrolls without any factor checks.
      */
-    float downsample(const std::array<float, Factor>& input)
+    template <int Factor>
+    void upsampleBlock(const FloatType* input, FloatType* output, int numSamples)
     {
-        float sum = 0.0f;
+        if constexpr (Factor == 1)
+        {
+            std::copy(input, input + numSamples * stride, output);
+        }
+        else
+        {
+            constexpr int order = filterOrder(Factor);
+            const FilterSet& set = filterSets[factorIndex(Factor)];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // Push into the mirrored history; window[0] is the newest frame
+                upsampleIndex = (upsampleIndex == 0 ? order : upsampleIndex) - 1;
+                const SampleType x = simd::load<SampleType>(input + i * stride);
+                simd::store(x, upsampleHistory.data() + upsampleIndex * stride);
+                simd::store(x, upsampleHistory.data() + (upsampleIndex + order) * stride);
+                const FloatType* window = upsampleHistory.data() + upsampleIndex * stride;
+
+                for (int phase = 0; phase < Factor; ++phase)
+                    simd::store(dotProduct<order>(window, set.phaseCoeffs[phase].data()), output + (i * Factor + phase) * stride);
+            }
+        }
+    }
 
-        // Anti-aliasing filter and decimate
-        for (int phase = 0; phase < Factor; ++phase)
+    /** downsampleBlock() for a factor fixed at compile time (see upsampleBlock<Factor>()) */
+    template <int Factor>
+    void downsampleBlock(const FloatType* input, FloatType* output, int numSamples)
+    {
+        if constexpr (Factor == 1)
+        {
+            std::copy(input, input + numSamples * stride, output);
+        }
+        else
         {
-            // Shift buffer and insert new sample
-            downsampleBuffer[downsampleIndex] = input[phase];
+            constexpr int historyLength = Factor * filterOrder(Factor);
+            constexpr int centre = prototypeLength(Factor) / 2;
+            const FilterSet& set = filterSets[factorIndex(Factor)];
 
-            // Apply filter at decimation point
-            if (phase == Factor - 1)
+            for (int i = 0; i < numSamples; ++i)
             {
-                for (int tap = 0; tap < FilterOrder; ++tap)
+                for (int phase = 0; phase < Factor; ++phase)
                 {
-                    int bufIdx = (downsampleIndex - tap * Factor + FilterOrder * Factor) % (FilterOrder * Factor);
-                    if (bufIdx < static_cast<int>(downsampleBuffer.size()))
-                    {
-                        sum += downsampleBuffer[bufIdx] * filterCoeffs[tap];
-                    }
+                    downsampleIndex = (downsampleIndex == 0 ? historyLength : downsampleIndex) - 1;
+                    const SampleType x = simd::load<SampleType>(input + (i * Factor + phase) * stride);
+                    simd::store(x, downsampleHistory.data() + downsampleIndex * stride);
+                    simd::store(x, downsampleHistory.data() + (downsampleIndex + historyLength) * stride);
                 }
-            }
 
-            downsampleIndex = (downsampleIndex + 1) % (FilterOrder * Factor);
+                // Decimate on phase 0 of the frame (keeps the latency an integer),
+                // then fold the symmetric prototype around its centre tap
+                const FloatType* window = downsampleHistory.data() + (downsampleIndex + Factor - 1) * stride;
+                const SampleType centreTap = simd::load<SampleType>(window + centre * stride) * SampleType(set.centreCoeff);
+                simd::store(centreTap + foldedDotProduct<Factor>(window, set.foldedCoeffs.data()), output + i * stride);
+            }
         }
-
-        return sum;
     }
 
     /**
@@ -101,94 +215,276 @@ public:
      * @return Downsampled output
      */
     template<typename ProcessFunc>
-    float process(float input, ProcessFunc processor)
+    SampleType process(SampleType input, ProcessFunc processor)
     {
-        std::array<float, Factor> upsampled;
-        upsample(input, upsampled);
+        std::array<FloatType, MaxFactor * stride> upsampled;
+        std::array<FloatType, stride> frame;
+        simd::store(input, frame.data());
+        upsampleBlock(frame.data(), upsampled.data(), 1);
 
         // Process each oversampled sample through the nonlinearity
-        for (int i = 0; i < Factor; ++i)
+        for (int i = 0; i < factor; ++i)
+            simd::store(processor(simd::load<SampleType>(upsampled.data() + i * stride)), upsampled.data() + i * stride);
+
+        downsampleBlock(upsampled.data(), frame.data(), 1);
+        return simd::load<SampleType>(frame.data());
+    }
+
+    /**
+     * Allocate the oversampled scratch used by processBlock()
+     * Sized for MaxFactor so factor changes never reallocate.
+     * @param maximumBlockSize Largest number of base-rate samples per call
+     */
+    void prepare(int maximumBlockSize)
+    {
+        oversampledBlock.assign(static_cast<size_t>(std::max(1, maximumBlockSize) * MaxFactor * stride), FloatType(0));
+        reset();
+    }
+
+    /**
+     * Process a block through oversampling with a block-level waveshaper
+     * @param buffer Base-rate samples, processed in place
+     * @param numSamples Number of base-rate samples
+     * @param processor Callable (FloatType* data, int numOversampledFrames)
+     *                  applied once per oversampled sub-block
+     */
+    template<typename BlockFunc>
+    void processBlock(FloatType* buffer, int numSamples, BlockFunc&& processor)
+    {
+        withFactor([&](auto f) { processBlock<decltype(f)::value>(buffer, numSamples, processor); });
+    }
+
+    /**
+     * processBlock() for a factor fixed at compile time, which must be the
+     * one selected by setFactor(). At 1x the processor runs on the buffer
+     * itself, with no copies through the scratch.
+     */
+    template<int Factor, typename BlockFunc>
+    void processBlock(FloatType* buffer, int numSamples, BlockFunc&& processor)
+    {
+        if constexpr (Factor == 1)
         {
-            upsampled[i] = processor(upsampled[i]);
+            processor(buffer, numSamples);
         }
+        else
+        {
+            const int maxChunk = static_cast<int>(oversampledBlock.size()) / (MaxFactor * stride);
+
+            for (int start = 0; start < numSamples; start += maxChunk)
+            {
+                const int chunk = std::min(maxChunk, numSamples - start);
+                FloatType* os = oversampledBlock.data();
+
+                upsampleBlock<Factor>(buffer + start * stride, os, chunk);
+                processor(os, chunk * Factor);
+                downsampleBlock<Factor>(os, buffer + start * stride, chunk);
+            }
+        }
+    }
 
-        return downsample(upsampled);
+    /** Map the selected factor onto a compile-time constant */
+    template <typename Func>
+    void withFactor(Func&& func) const
+    {
+        switch (factor)
+        {
+            case 2:  func(std::integral_constant<int, 2>{}); break;
+            case 4:  func(std::integral_constant<int, 4>{}); break;
+            case 8:  func(std::integral_constant<int, 8>{}); break;
+            case 16: func(std::integral_constant<int, 16>{}); break;
+            default: func(std::integral_constant<int, 1>{}); break;
+        }
     }
 
 private:
-    void initializeFilter()
+    using Vec = simd::Vec<FloatType>;
+
+    struct FilterSet
     {
-        // Design lowpass FIR filter at Nyquist/4 (cutoff = 0.25 * Fs)
-        // Using windowed-sinc design with Kaiser window
-        constexpr float cutoff = 0.22f;  // Slightly below Nyquist/4 for better rolloff
-        constexpr float beta = 7.0f;     // Kaiser window beta
+        std::vector<std::array<FloatType, MaxFilterOrder>> phaseCoeffs;   // One zero-padded branch per phase
+        std::vector<FloatType> foldedCoeffs;                          // First half of the prototype, padded
+        FloatType centreCoeff = 0;
+    };
 
-        for (int i = 0; i < FilterOrder; ++i)
+    /**
+     * Order-tap dot product of a contiguous window. Planar, it is SIMD over
+     * taps with two accumulators to hide the add latency. Over lanes, each
+     * tap is one frame times a broadcast coefficient, and four accumulators
+     * keep the multiply-adds independent.
+     */
+    template <int Order>
+    static SampleType dotProduct(const FloatType* window, const FloatType* coeffs)
+    {
+        if constexpr (stride == 1)
         {
-            float n = static_cast<float>(i) - static_cast<float>(HalfOrder - 1);
+            static_assert(Order % (2 * Vec::size) == 0, "Branch length must fill whole vectors");
 
-            // Sinc function
-            float sinc;
-            if (std::fabs(n) < 1e-6f)
+            Vec acc0(FloatType(0)), acc1(FloatType(0));
+            for (int tap = 0; tap < Order; tap += 2 * Vec::size)
             {
-                sinc = 2.0f * cutoff;
+                acc0 = simd::mulAdd(Vec::load(window + tap), Vec::load(coeffs + tap), acc0);
+                acc1 = simd::mulAdd(Vec::load(window + tap + Vec::size), Vec::load(coeffs + tap + Vec::size), acc1);
             }
-            else
+            return simd::sum(acc0 + acc1);
+        }
+        else
+        {
+            static_assert(Order % 4 == 0, "Branch length must fill the accumulators");
+
+            SampleType acc0(FloatType(0)), acc1(FloatType(0)), acc2(FloatType(0)), acc3(FloatType(0));
+            for (int tap = 0; tap < Order; tap += 4)
             {
-                float x = 2.0f * 3.14159265359f * cutoff * n;
-                sinc = std::sin(x) / (3.14159265359f * n);
+                acc0 = simd::mulAdd(simd::load<SampleType>(window + tap * stride), SampleType(coeffs[tap]), acc0);
+                acc1 = simd::mulAdd(simd::load<SampleType>(window + (tap + 1) * stride), SampleType(coeffs[tap + 1]), acc1);
+                acc2 = simd::mulAdd(simd::load<SampleType>(window + (tap + 2) * stride), SampleType(coeffs[tap + 2]), acc2);
+                acc3 = simd::mulAdd(simd::load<SampleType>(window + (tap + 3) * stride), SampleType(coeffs[tap + 3]), acc3);
             }
+            return (acc0 + acc1) + (acc2 + acc3);
+        }
+    }
 
-            // Kaiser window
-            float windowArg = 1.0f - std::pow(2.0f * static_cast<float>(i) / (FilterOrder - 1) - 1.0f, 2.0f);
-            windowArg = std::max(0.0f, windowArg);
-            float window = bessel_i0(beta * std::sqrt(windowArg)) / bessel_i0(beta);
+    static constexpr int longestDesign()
+    {
+        int longest = 0;
+        for (const auto& design : designs)
+            longest = std::max(longest, design.filterOrder);
+        return longest;
+    }
 
-            filterCoeffs[i] = sinc * window;
-        }
+    /** Prototype length for a factor: odd, so there is a centre tap */
+    static constexpr int prototypeLength(int overFactor) { return overFactor * (filterOrder(overFactor) - 1) + 1; }
+
+    /** Taps ahead of the centre, padded to whole vectors of any backend */
+    static constexpr int foldedLength(int overFactor) { return (prototypeLength(overFactor) / 2 + 7) / 8 * 8; }
+
+    static constexpr int factorIndex(int overFactor)
+    {
+        int index = 0;
+        while ((1 << index) < overFactor)
+            ++index;
+        return index;
+    }
+
+    /**
+     * Symmetric FIR: sum of h[k] * (w[k] + w[N-1-k]) over the first half.
+     * The padding taps past the centre are zero, and their mirror images
+     * still fall inside the window.
+     */
+    template <int Factor>
+    static SampleType foldedDotProduct(const FloatType* window, const FloatType* coeffs)
+    {
+        constexpr int numTaps = foldedLength(Factor);
+        const FloatType* mirror = window + (prototypeLength(Factor) - 1) * stride;
 
-        // Normalize filter
-        float sum = 0.0f;
-        for (int i = 0; i < FilterOrder; ++i)
+        if constexpr (stride == 1)
         {
-            sum += filterCoeffs[i];
+            static_assert(numTaps % Vec::size == 0, "Folded taps must fill whole vectors");
+
+            Vec acc(FloatType(0));
+            for (int tap = 0; tap < numTaps; tap += Vec::size)
+            {
+                Vec pair = Vec::load(window + tap) + Vec::loadReversed(mirror - tap);
+                acc = simd::mulAdd(pair, Vec::load(coeffs + tap), acc);
+            }
+            return simd::sum(acc);
         }
-        for (int i = 0; i < FilterOrder; ++i)
+        else
         {
-            filterCoeffs[i] /= sum;
+            static_assert(numTaps % 4 == 0, "Folded taps must fill the accumulators");
+
+            auto pair = [&](int tap) {
+                return simd::load<SampleType>(window + tap * stride) + simd::load<SampleType>(mirror - tap * stride);
+            };
+
+            SampleType acc0(FloatType(0)), acc1(FloatType(0)), acc2(FloatType(0)), acc3(FloatType(0));
+            for (int tap = 0; tap < numTaps; tap += 4)
+            {
+                acc0 = simd::mulAdd(pair(tap), SampleType(coeffs[tap]), acc0);
+                acc1 = simd::mulAdd(pair(tap + 1), SampleType(coeffs[tap + 1]), acc1);
+                acc2 = simd::mulAdd(pair(tap + 2), SampleType(coeffs[tap + 2]), acc2);
+                acc3 = simd::mulAdd(pair(tap + 3), SampleType(coeffs[tap + 3]), acc3);
+            }
+            return (acc0 + acc1) + (acc2 + acc3);
         }
     }
 
-    float getFilterCoeff(int index) const
+    static void initializeFilter(FilterSet& set, int overFactor)
     {
-        int coeffIdx = index / Factor;
-        if (coeffIdx < FilterOrder)
+        // Design the lowpass prototype at the oversampled rate.
+        // Cutoff is 0.22 of the base rate, i.e. 0.22 / factor here.
+        // Using windowed-sinc design with Kaiser window
+        const double cutoff = 0.22 / overFactor;
+        const double beta = designs[factorIndex(overFactor)].beta;
+        constexpr double pi = 3.14159265358979323846;
+
+        const int length = prototypeLength(overFactor);
+        const int centre = (length - 1) / 2;
+
+        std::vector<double> prototype(static_cast<size_t>(length));
+        double sum = 0.0;
+
+        for (int i = 0; i < length; ++i)
+        {
+            double n = static_cast<double>(i - centre);
+
+            // Sinc function
+            double sinc = (i == centre) ? 2.0 * cutoff
+                                        : std::sin(2.0 * pi * cutoff * n) / (pi * n);
+
+            // Kaiser window
+            double ratio = n / static_cast<double>(centre);
+            double window = bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / bessel_i0(beta);
+
+            prototype[static_cast<size_t>(i)] = sinc * window;
+            sum += prototype[static_cast<size_t>(i)];
+        }
+
+        // Decimator: unity DC gain, first half only (the rest mirrors it).
+        // Taps past the centre stay zero so the vector loop needs no tail.
+        set.foldedCoeffs.assign(static_cast<size_t>(foldedLength(overFactor)), FloatType(0));
+        for (int i = 0; i < centre; ++i)
+            set.foldedCoeffs[static_cast<size_t>(i)] = static_cast<FloatType>(prototype[static_cast<size_t>(i)] / sum);
+        set.centreCoeff = static_cast<FloatType>(prototype[static_cast<size_t>(centre)] / sum);
+
+        // Split into polyphase branches for the interpolator. Zero-stuffing
+        // loses a factor of the oversampling factor in level, so each branch is scaled back up.
+        // Branch p holds taps p, p + factor, p + 2*factor, ... (zero-padded)
+        set.phaseCoeffs.assign(static_cast<size_t>(overFactor), {});
+        for (int phase = 0; phase < overFactor; ++phase)
         {
-            return filterCoeffs[coeffIdx];
+            auto& branch = set.phaseCoeffs[static_cast<size_t>(phase)];
+            branch.fill(FloatType(0));
+            for (int tap = phase, k = 0; tap < length; tap += overFactor, ++k)
+                branch[static_cast<size_t>(k)] = static_cast<FloatType>(overFactor * prototype[static_cast<size_t>(tap)] / sum);
         }
-        return 0.0f;
     }
 
     // Modified Bessel function of the first kind, order 0
-    static float bessel_i0(float x)
+    static double bessel_i0(double x)
     {
-        float sum = 1.0f;
-        float term = 1.0f;
-        float xHalfSq = (x / 2.0f) * (x / 2.0f);
+        double sum = 1.0;
+        double term = 1.0;
+        double xHalfSq = (x / 2.0) * (x / 2.0);
 
-        for (int k = 1; k < 20; ++k)
+        for (int k = 1; k < 50; ++k)
         {
-            term *= xHalfSq / (static_cast<float>(k) * static_cast<float>(k));
+            term *= xHalfSq / (static_cast<double>(k) * static_cast<double>(k));
             sum += term;
-            if (term < 1e-10f) break;
+            if (term < 1e-12 * sum) break;
         }
 
         return sum;
     }
 
-    std::array<float, FilterOrder> filterCoeffs{};
-    std::array<float, FilterOrder> upsampleBuffer{};
-    std::array<float, FilterOrder * Factor> downsampleBuffer{};
+    std::array<FilterSet, NumFactors> filterSets;  // Index = log2(factor); [0] is the 1x bypass
+    int factor = 1;
+
+    std::array<FloatType, 2 * MaxFilterOrder * stride> upsampleHistory{};
+    std::array<FloatType, 2 * MaxDecimatorHistory * stride> downsampleHistory{};
     int upsampleIndex = 0;
     int downsampleIndex = 0;
+
+    std::vector<FloatType> oversampledBlock = std::vector<FloatType>(MaxFactor * stride, FloatType(0));
 };
+
+using Oversampler = BasicOversampler<float>;
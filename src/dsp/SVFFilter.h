@@ -1,11 +1,23 @@
 #pragma once
 
 #include <cmath>
+#include <algorithm>
+#include <array>
+#include "Simd.h"
+#include "FastMath.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+/** Filter response, shared by every BasicSVFFilter instantiation */
+enum class SVFMode
+{
+    LowPass = 0,
+    HighPass,
+    BandPass
+};
+
 /**
  * SVFFilter - State Variable Filter
  *
@@ -13,50 +25,85 @@
  * - High Pass (Stellar Flare): Distorts only the highs
  * - Low Pass (Deep Core): Distorts only the lows
  * - Band Pass (Coronal Loop): Focused resonant distortion
+ *
+ * SampleType is float or double, or a simd::Vec of either to run one channel
+ * per lane with shared coefficients (see ChannelStrip). Block data is then
+ * interleaved: frame i occupies simd::lanes<SampleType> consecutive values.
+ * Coefficients and block buffers use the scalar type underneath (FloatType).
+ *
+ * Coefficients are only recomputed when a parameter actually changes, and
+ * processBlock() then glides to them per sample instead of jumping. For
+ * audio-rate cutoff modulation, the overload taking a cutoff per frame
+ * derives every frame's coefficients with FastMath::tanPi.
  */
-class SVFFilter
+template <typename SampleType>
+class BasicSVFFilter
 {
 public:
-    enum class Mode
-    {
-        LowPass = 0,
-        HighPass,
-        BandPass
-    };
+    using Mode = SVFMode;
+    using FloatType = simd::ScalarType<SampleType>;
 
-    SVFFilter() : ic1eq(0.0f), ic2eq(0.0f), sampleRate(44100.0f) {}
+    BasicSVFFilter() : ic1eq(FloatType(0)), ic2eq(FloatType(0)), sampleRate(44100.0f) {}
 
     void prepare(float newSampleRate)
     {
         sampleRate = newSampleRate;
+
+        // Force the next setParameters() to recompute and jump straight there
+        lastFrequency = -1.0f;
+        snapToTarget = true;
         reset();
     }
 
     void reset()
     {
-        ic1eq = 0.0f;
-        ic2eq = 0.0f;
+        ic1eq = FloatType(0);
+        ic2eq = FloatType(0);
+    }
+
+    /** True once both states have decayed to at most threshold in every lane */
+    bool isSilent(float threshold) const
+    {
+        return simd::peak(ic1eq) <= threshold && simd::peak(ic2eq) <= threshold;
     }
 
     /**
      * Set filter parameters
+     * The next processBlock() ramps from the current coefficients to these.
      * @param frequency Cutoff frequency in Hz (20-20000)
      * @param resonance Q factor (0.1-1.0, mapped internally)
      */
     void setParameters(float frequency, float resonance)
     {
+        // Static controls cost a compare, not a tan()
+        if (frequency == lastFrequency && resonance == lastResonance)
+            return;
+
+        lastFrequency = frequency;
+        lastResonance = resonance;
+
         // Clamp frequency
         frequency = std::fmax(20.0f, std::fmin(frequency, sampleRate * 0.49f));
 
         // Map resonance (0.1-1.0) to Q (0.5-10.0)
-        float q = 0.5f + resonance * 9.5f;
+        const FloatType q = FloatType(0.5f + resonance * 9.5f);
 
         // Calculate coefficients using the TPT (Topology Preserving Transform)
-        g = std::tan(static_cast<float>(M_PI) * frequency / sampleRate);
-        k = 1.0f / q;
-        a1 = 1.0f / (1.0f + g * (g + k));
-        a2 = g * a1;
-        a3 = g * a2;
+        const FloatType g = std::tan(static_cast<FloatType>(M_PI) * FloatType(frequency) / FloatType(sampleRate));
+        target.k = FloatType(1) / q;
+        target.a1 = FloatType(1) / (FloatType(1) + g * (g + target.k));
+        target.a2 = g * target.a1;
+        target.a3 = g * target.a2;
+
+        if (snapToTarget)
+        {
+            current = target;
+            snapToTarget = false;
+        }
+        else
+        {
+            ramping = true;
+        }
     }
 
     /**
@@ -65,47 +112,271 @@ public:
      * @param mode The filter mode (LP, HP, BP)
      * @return The filtered sample
      */
-    float processSample(float input, Mode mode)
+    SampleType processSample(SampleType input, Mode mode)
+    {
+        switch (mode)
+        {
+            case Mode::HighPass: return processSample<Mode::HighPass>(input);
+            case Mode::BandPass: return processSample<Mode::BandPass>(input);
+            case Mode::LowPass:
+            default:             return processSample<Mode::LowPass>(input);
+        }
+    }
+
+    /** processSample() with the mode fixed at compile time */
+    template <Mode mode>
+    SampleType processSample(SampleType input)
     {
+        // No ramp here: jump to the latest coefficients
+        current = target;
+        ramping = false;
+
+        const FloatType k = current.k, a1 = current.a1, a2 = current.a2, a3 = current.a3;
+
         // TPT SVF processing
-        float v3 = input - ic2eq;
-        float v1 = a1 * ic1eq + a2 * v3;
-        float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        SampleType v3 = input - ic2eq;
+        SampleType v1 = a1 * ic1eq + a2 * v3;
+        SampleType v2 = ic2eq + a2 * ic1eq + a3 * v3;
 
-        ic1eq = 2.0f * v1 - ic1eq;
-        ic2eq = 2.0f * v2 - ic2eq;
+        ic1eq = FloatType(2) * v1 - ic1eq;
+        ic2eq = FloatType(2) * v2 - ic2eq;
 
-        // Select output based on mode
+        return output<mode>(input, k, v1, v2);
+    }
+
+    /**
+     * Process a block of frames in place
+     * The mode is resolved once per block rather than once per sample, and
+     * so is whether the coefficients are gliding.
+     */
+    void processBlock(FloatType* buffer, int numFrames, Mode mode)
+    {
         switch (mode)
         {
+            case Mode::HighPass:
+                processBlock<Mode::HighPass>(buffer, numFrames);
+                break;
+
+            case Mode::BandPass:
+                processBlock<Mode::BandPass>(buffer, numFrames);
+                break;
+
             case Mode::LowPass:
-                return v2;
+            default:
+                processBlock<Mode::LowPass>(buffer, numFrames);
+                break;
+        }
+    }
+
+    /** processBlock() with the mode fixed at compile time */
+    template <Mode mode>
+    void processBlock(FloatType* buffer, int numFrames)
+    {
+        if (ramping)
+            processFrames<mode, true>(buffer, numFrames);
+        else
+            processFrames<mode, false>(buffer, numFrames);
+    }
 
+    /**
+     * Process a block of frames in place with a cutoff per frame
+     * Coefficients are generated SIMD across time, a sub-block ahead of the
+     * recursion, so a swept filter costs little more than a static one.
+     * Resonance comes from the last setParameters() call and glides to it
+     * across the block, as in the unmodulated path.
+     * @param cutoff numFrames cutoff frequencies in Hz
+     */
+    void processBlock(FloatType* buffer, const FloatType* cutoff, int numFrames, Mode mode)
+    {
+        switch (mode)
+        {
             case Mode::HighPass:
-                return input - k * v1 - v2;
+                processBlock<Mode::HighPass>(buffer, cutoff, numFrames);
+                break;
 
             case Mode::BandPass:
-                return v1;
+                processBlock<Mode::BandPass>(buffer, cutoff, numFrames);
+                break;
 
+            case Mode::LowPass:
             default:
-                return v2;
+                processBlock<Mode::LowPass>(buffer, cutoff, numFrames);
+                break;
+        }
+    }
+
+    /** Modulated processBlock() with the mode fixed at compile time */
+    template <Mode mode>
+    void processBlock(FloatType* buffer, const FloatType* cutoff, int numFrames)
+    {
+        if (numFrames > 0)
+            processBlockModulated<mode>(buffer, cutoff, numFrames);
+    }
+
+private:
+    /** Frames of coefficients generated ahead of the recursion (stack scratch) */
+    static constexpr int modulationBlock = 32;
+
+    struct Coefficients
+    {
+        FloatType k = 2;            // 1 / Q
+        FloatType a1 = 1, a2 = 0, a3 = 0;
+    };
+
+    /** Output tap for the mode; the others are dead code once it is fixed */
+    template <Mode mode, typename T>
+    static T output(T input, FloatType k, T v1, T v2)
+    {
+        if constexpr (mode == Mode::LowPass)
+            return v2;
+        else if constexpr (mode == Mode::HighPass)
+            return input - k * v1 - v2;
+        else
+            return v1;
+    }
+
+    template <Mode mode, bool ramp>
+    void processFrames(FloatType* buffer, int numFrames)
+    {
+        constexpr int stride = simd::lanes<SampleType>;
+
+        // States and coefficients in locals so the recursion never round-trips through memory
+        SampleType s1 = ic1eq, s2 = ic2eq;
+        FloatType k = current.k, a1 = current.a1, a2 = current.a2, a3 = current.a3;
+
+        // Linear glide that lands on the target at the last frame
+        Coefficients step;
+        if constexpr (ramp)
+        {
+            const FloatType scale = FloatType(1) / static_cast<FloatType>(std::max(1, numFrames));
+            step.k = (target.k - k) * scale;
+            step.a1 = (target.a1 - a1) * scale;
+            step.a2 = (target.a2 - a2) * scale;
+            step.a3 = (target.a3 - a3) * scale;
+        }
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if constexpr (ramp)
+            {
+                k += step.k;
+                a1 += step.a1;
+                a2 += step.a2;
+                a3 += step.a3;
+            }
+
+            const SampleType input = simd::load<SampleType>(buffer + i * stride);
+            const SampleType v3 = input - s2;
+            const SampleType v1 = a1 * s1 + a2 * v3;
+            const SampleType v2 = s2 + a2 * s1 + a3 * v3;
+
+            s1 = FloatType(2) * v1 - s1;
+            s2 = FloatType(2) * v2 - s2;
+
+            simd::store(output<mode>(input, k, v1, v2), buffer + i * stride);
+        }
+
+        ic1eq = s1;
+        ic2eq = s2;
+
+        if constexpr (ramp)
+        {
+            current = target;
+            ramping = false;
         }
     }
 
     /**
-     * Process a block of samples
+     * Coefficients for one frame (or Vec::size frames) of cutoff, same
+     * mapping as setParameters() but with FastMath::tanPi
      */
-    void processBlock(float* buffer, int numSamples, Mode mode)
+    template <typename T>
+    void computeCoefficients(T frequency, T k, T& a1, T& a2, T& a3) const
+    {
+        const T x = simd::min(simd::max(frequency, T(20.0f)), T(FloatType(sampleRate * 0.49f))) * T(FloatType(1) / FloatType(sampleRate));
+        const T g = FastMath::tanPi(x);
+
+        a1 = T(1.0f) / simd::mulAdd(g, g + k, T(1.0f));
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+
+    template <Mode mode>
+    void processBlockModulated(FloatType* buffer, const FloatType* cutoff, int numFrames)
     {
-        for (int i = 0; i < numSamples; ++i)
+        using Vec = simd::Vec<FloatType>;
+        constexpr int stride = simd::lanes<SampleType>;
+        static_assert(modulationBlock % Vec::size == 0, "Sub-blocks must fill whole vectors");
+
+        // Resonance has no per-frame input: glide 1/Q linearly to its latest
+        // value, landing on it at the last frame (as processFrames() does)
+        const FloatType kStart = current.k;
+        const FloatType kStep = (target.k - kStart) / static_cast<FloatType>(numFrames);
+
+        std::array<FloatType, modulationBlock> ks, a1s, a2s, a3s;
+        SampleType s1 = ic1eq, s2 = ic2eq;
+
+        for (int start = 0; start < numFrames; start += modulationBlock)
         {
-            buffer[i] = processSample(buffer[i], mode);
+            const int count = std::min(modulationBlock, numFrames - start);
+            const FloatType* f = cutoff + start;
+
+            for (int i = 0; i < count; ++i)
+                ks[static_cast<size_t>(i)] = kStart + kStep * static_cast<FloatType>(start + i + 1);
+
+            // Coefficients: SIMD across frames, scalar tail runs the same maths
+            int i = 0;
+            for (; i + Vec::size <= count; i += Vec::size)
+            {
+                Vec a1, a2, a3;
+                computeCoefficients(Vec::load(f + i), Vec::load(ks.data() + i), a1, a2, a3);
+                a1.store(a1s.data() + i);
+                a2.store(a2s.data() + i);
+                a3.store(a3s.data() + i);
+            }
+
+            for (; i < count; ++i)
+                computeCoefficients(f[i], ks[static_cast<size_t>(i)], a1s[static_cast<size_t>(i)], a2s[static_cast<size_t>(i)], a3s[static_cast<size_t>(i)]);
+
+            // Recursion, reading one precomputed coefficient set per frame
+            FloatType* frames = buffer + start * stride;
+            for (i = 0; i < count; ++i)
+            {
+                const FloatType k = ks[static_cast<size_t>(i)];
+                const FloatType a1 = a1s[static_cast<size_t>(i)], a2 = a2s[static_cast<size_t>(i)], a3 = a3s[static_cast<size_t>(i)];
+
+                const SampleType input = simd::load<SampleType>(frames + i * stride);
+                const SampleType v3 = input - s2;
+                const SampleType v1 = a1 * s1 + a2 * v3;
+                const SampleType v2 = s2 + a2 * s1 + a3 * v3;
+
+                s1 = FloatType(2) * v1 - s1;
+                s2 = FloatType(2) * v2 - s2;
+
+                simd::store(output<mode>(input, k, v1, v2), frames + i * stride);
+            }
         }
+
+        ic1eq = s1;
+        ic2eq = s2;
+
+        // Settle on the last frame's coefficients, so a following
+        // setParameters() with that cutoff has nothing to do
+        const size_t last = static_cast<size_t>((numFrames - 1) % modulationBlock);
+        current = { target.k, a1s[last], a2s[last], a3s[last] };
+        target = current;
+        ramping = false;
+        lastFrequency = static_cast<float>(cutoff[numFrames - 1]);
     }
 
-private:
-    float ic1eq, ic2eq;     // State variables
+    SampleType ic1eq, ic2eq;    // State variables (one per lane)
     float sampleRate;
-    float g, k;             // Filter coefficients
-    float a1, a2, a3;       // Derived coefficients
+
+    Coefficients current, target;   // Filter coefficients (shared by all lanes)
+    float lastFrequency = -1.0f;    // Controls the target was computed from
+    float lastResonance = -1.0f;
+    bool ramping = false;           // current still gliding towards target
+    bool snapToTarget = true;       // First update after prepare() jumps
 };
+
+using SVFFilter = BasicSVFFilter<float>;
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include "FastMath.h"
+#include "ShaperTable.h"
 
 /**
  * SanguinovaEngine - Core Distortion Engine
@@ -8,11 +13,41 @@
  * Implements Hyperbolic Asymmetry algorithm:
  * - Positive cycle: Exponential saturation (warm, tube-like)
  * - Negative cycle: Rational folding (gritty, compressed)
+ *
+ * processSample() is the exact scalar reference. The block path hoists the
+ * input gain out of the loop and runs a branch-free SIMD kernel built on
+ * FastMath::exp, so it is the one to use from the oversampled audio path.
+ *
+ * The block path can instead run antiderivative anti-aliasing (ADAA). Both
+ * halves of the transfer function have closed-form antiderivatives, so
+ * first- or second-order ADAA suppresses aliasing at 1x or 2x about as well
+ * as plain shaping at 4x. ADAA also averages, which droops the highs (1.2 or
+ * 3.2 dB at 0.16 of the rate it runs at), so its input first goes through a
+ * 3-tap linear-phase shelf that lifts them back. Together they delay by 1.5
+ * or 2 samples.
+ *
+ * Plain shaping can optionally read a cubic-interpolated lookup table
+ * instead of evaluating exp (see setLookupTable()). The table is taken after
+ * the input gain, so one table serves every drive and stage setting and is
+ * shared by all engines of a precision.
+ *
+ * FloatType (float or double) is the sample type of both paths; the block
+ * kernel runs on simd::Vec<FloatType>.
  */
-class SanguinovaEngine
+template <typename FloatType>
+class BasicSanguinovaEngine
 {
 public:
-    SanguinovaEngine() = default;
+    /**
+     * Input gain at 0 dB drive with no stages engaged. The original 4x
+     * oversampler fed the shaper 12 dB hot (its interpolator made up for the
+     * zero-stuffing loss twice over), and the drive range and presets are
+     * voiced for that level. The oversamplers are unity gain now, so the
+     * engine keeps the +12 dB instead.
+     */
+    static constexpr float unityDriveGain = 4.0f;
+
+    BasicSanguinovaEngine() = default;
 
     /**
      * Process a single sample through the asymmetric waveshaper
@@ -21,29 +56,150 @@ public:
      * @param stageMult The combinatorial stage multiplier (1x to 100x)
      * @return The distorted sample
      */
-    float processSample(float input, float driveDb, float stageMult)
+    FloatType processSample(FloatType input, float driveDb, float stageMult)
+    {
+        // The dB conversion only reruns when drive or stages actually change
+        setParameters(driveDb, stageMult);
+        return processSample(input);
+    }
+
+    /**
+     * Process a single sample with the gain set by setParameters(), taken
+     * outright (no ramp)
+     */
+    FloatType processSample(FloatType input)
     {
         // 1. Apply Gain and Multiplier
-        // Convert dB to linear gain: gain = 10^(dB/20)
-        float driveLinear = std::pow(10.0f, driveDb / 20.0f);
-        float x = input * driveLinear * stageMult;
+        FloatType x = input * targetGain;
 
         // 2. Asymmetrical Transfer Function
-        float output;
-        if (x > 0.0f)
+        FloatType output;
+        if (x > FloatType(0))
         {
             // Positive cycle: Exponential saturation (warm, soft tube-like)
-            output = 1.0f - std::exp(-x);
+            output = FloatType(1) - std::exp(-x);
         }
         else
         {
             // Negative cycle: Rational folding (gritty, compressed)
-            output = x / (1.0f + (x * x));
+            output = x / (FloatType(1) + (x * x));
         }
 
         return output;
     }
 
+    /**
+     * Set drive and stage multiplier for the block path; the input gain is
+     * their product with unityDriveGain.
+     * The dB-to-linear conversion only runs when a value actually changes,
+     * and the next processBlock() then ramps the input gain per sample.
+     */
+    void setParameters(float driveDb, float stageMult)
+    {
+        if (driveDb != lastDriveDb || stageMult != lastStageMult)
+        {
+            lastDriveDb = driveDb;
+            lastStageMult = stageMult;
+            targetGain = std::pow(FloatType(10), FloatType(driveDb) / FloatType(20)) * FloatType(stageMult) * FloatType(unityDriveGain);
+
+            // Nothing to glide from straight after a reset
+            if (snapToTarget)
+                inputGain = targetGain;
+        }
+    }
+
+    /**
+     * Select the block path's anti-aliasing: 0 = plain shaping, 1 or 2 =
+     * first- or second-order ADAA. Changing the order clears the ADAA state.
+     */
+    void setAntiderivativeOrder(int order)
+    {
+        order = std::clamp(order, 0, 2);
+        if (order != adaaOrder)
+        {
+            adaaOrder = order;
+            reset();
+        }
+    }
+
+    int getAntiderivativeOrder() const { return adaaOrder; }
+
+    /**
+     * Shape through the lookup table instead of the closed form (plain
+     * shaping only: ADAA keeps its exact antiderivatives). Matches shape()
+     * to about 1e-7. The first call that enables it builds the shared table,
+     * so make it from prepare time, not the audio thread.
+     */
+    void setLookupTable(bool shouldUseTable)
+    {
+        table = shouldUseTable ? &lookupTable() : nullptr;
+    }
+
+    bool isUsingLookupTable() const { return table != nullptr; }
+
+    /**
+     * True where shaping from the table beats the closed form: the scalar
+     * and NEON backends, and double on SSE2. SSE2 float and AVX2 double only
+     * break even, and AVX2 float is twice as slow (its gathers).
+     */
+#if SANGUINOVA_SIMD_AVX2
+    static constexpr bool lookupTableIsFaster = false;
+#elif SANGUINOVA_SIMD_SSE2
+    static constexpr bool lookupTableIsFaster = std::is_same_v<FloatType, double>;
+#else
+    static constexpr bool lookupTableIsFaster = true;
+#endif
+
+    /** The table shared by every engine of this precision, built on first use */
+    static const BasicShaperTable<FloatType>& lookupTable()
+    {
+        static const BasicShaperTable<FloatType> shared(transfer, derivative);
+        return shared;
+    }
+
+    /** Linear gain ahead of the transfer function (drive x stages) that processBlock() glides to */
+    FloatType getInputGain() const { return targetGain; }
+
+    /** Delay added by ADAA and its droop compensation, in samples at the rate the engine runs at */
+    float getLatencyInSamples() const { return adaaOrder > 0 ? 1.0f + 0.5f * static_cast<float>(adaaOrder) : 0.0f; }
+
+    /**
+     * Clear the ADAA history (previous inputs, antiderivative values and
+     * the compensation shelf). A gain change before the next block is applied
+     * without a ramp.
+     */
+    void reset()
+    {
+        snapToTarget = true;
+        x1 = x2 = 0.0;
+        ad1 = 0.0;
+        d1 = 0.0;
+        e1 = e2 = 0.0;
+    }
+
+    /**
+     * Process a block of samples with the gain set by setParameters()
+     * @param buffer Pointer to the sample buffer
+     * @param numSamples Number of samples to process
+     */
+    void processBlock(FloatType* buffer, int numSamples)
+    {
+        snapToTarget = false;
+
+        if (targetGain != inputGain)
+            return processBlockRamped(buffer, numSamples);
+
+        if (adaaOrder == 1)
+            return processBlockADAA1(buffer, numSamples, inputGain, FloatType(0));
+        if (adaaOrder == 2)
+            return processBlockADAA2(buffer, numSamples, inputGain, FloatType(0));
+
+        if (table != nullptr)
+            return shapeBlock<false>(buffer, numSamples, inputGain, FloatType(0), [this](auto x) { return shapeFromTable(x); });
+
+        shapeBlock<false>(buffer, numSamples, inputGain, FloatType(0), [](auto x) { return shape(x); });
+    }
+
     /**
      * Process a block of samples
      * @param buffer Pointer to the sample buffer
@@ -51,13 +207,243 @@ public:
      * @param driveDb The drive amount in dB (0-40)
      * @param stageMult The combinatorial stage multiplier
      */
-    void processBlock(float* buffer, int numSamples, float drive, float stageMult)
+    void processBlock(FloatType* buffer, int numSamples, float drive, float stageMult)
+    {
+        setParameters(drive, stageMult);
+        processBlock(buffer, numSamples);
+    }
+
+    /**
+     * Branch-free asymmetric transfer function (post-gain).
+     * Both halves are evaluated and the sign mask picks one; the exp argument
+     * is clamped to <= 0 so the unused positive half can never overflow.
+     */
+    template <typename T>
+    static T shape(T x)
+    {
+        const T one(1.0f);
+        const T positive = one - FastMath::exp(-simd::max(x, T(0.0f)));
+        const T negative = x / simd::mulAdd(x, x, one);
+        return simd::select(simd::greaterThan(x, T(0.0f)), positive, negative);
+    }
+
+private:
+    /** Glide the input gain linearly to its target, landing on it at the last sample */
+    void processBlockRamped(FloatType* buffer, int numSamples)
+    {
+        const FloatType step = (targetGain - inputGain) / static_cast<FloatType>(std::max(1, numSamples));
+        const FloatType start = inputGain + step;
+        inputGain = targetGain;
+
+        if (adaaOrder == 1)
+            return processBlockADAA1(buffer, numSamples, start, step);
+        if (adaaOrder == 2)
+            return processBlockADAA2(buffer, numSamples, start, step);
+
+        if (table != nullptr)
+            return shapeBlock<true>(buffer, numSamples, start, step, [this](auto x) { return shapeFromTable(x); });
+
+        shapeBlock<true>(buffer, numSamples, start, step, [](auto x) { return shape(x); });
+    }
+
+    /** Plain shaping of a block, SIMD over samples, at a constant gain or a linear ramp from start */
+    template <bool ramp, typename ShapeFunc>
+    static void shapeBlock(FloatType* buffer, int numSamples, FloatType start, FloatType step, ShapeFunc&& shapeFunc)
+    {
+        using Vec = simd::Vec<FloatType>;
+        int i = 0;
+
+        if constexpr (ramp)
+        {
+            static constexpr FloatType laneOffsets[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+            static_assert(std::size(laneOffsets) >= Vec::size, "One offset per lane");
+
+            const Vec laneSteps = Vec::load(laneOffsets) * Vec(step);
+
+            for (; i + Vec::size <= numSamples; i += Vec::size)
+            {
+                const Vec gain = Vec(start + step * static_cast<FloatType>(i)) + laneSteps;
+                shapeFunc(Vec::load(buffer + i) * gain).store(buffer + i);
+            }
+
+            for (; i < numSamples; ++i)
+                buffer[i] = shapeFunc(buffer[i] * (start + step * static_cast<FloatType>(i)));
+        }
+        else
+        {
+            const Vec gain(start);
+
+            for (; i + Vec::size <= numSamples; i += Vec::size)
+                shapeFunc(Vec::load(buffer + i) * gain).store(buffer + i);
+
+            for (; i < numSamples; ++i)
+                buffer[i] = shapeFunc(buffer[i] * start);
+        }
+    }
+
+    /**
+     * shape() from the lookup table. Past its range the positive half is 1
+     * to within exp(-Range) (below float resolution) and the negative half
+     * is cheap in closed form; vectors entirely inside skip both.
+     */
+    template <typename T>
+    T shapeFromTable(T x) const
+    {
+        const T inside = table->process(x);
+        const auto outside = simd::greaterThan(simd::abs(x), T(static_cast<FloatType>(BasicShaperTable<FloatType>::Range)));
+
+        if (! simd::anyTrue(outside))
+            return inside;
+
+        const T one(FloatType(1));
+        const T tail = simd::select(simd::greaterThan(x, T(FloatType(0))), one, x / simd::mulAdd(x, x, one));
+        return simd::select(outside, tail, inside);
+    }
+
+    /*
+     * ADAA runs in double for either FloatType: the antiderivatives grow like
+     * x and x^2 while the input reaches 4e4 at full drive, so float
+     * differences would cancel.
+     * The ill-conditioning threshold scales with |x| for the same reason.
+     */
+    static constexpr double adaaTolerance = 1.0e-5;
+
+    static bool illConditioned(double a, double b)
+    {
+        return std::abs(a - b) < adaaTolerance * std::max(1.0, std::abs(a));
+    }
+
+    /*
+     * In its linear region ADAA is an average of consecutive inputs:
+     * (1 + z^-1) / 2 at first order, (1 + z^-1 + z^-2) / 3 at second. The
+     * shelf -c + (1 + 2c) z^-1 - c z^-2 undoes that droop; c is fitted so the
+     * product is exactly flat at 0.16 of the rate, and stays within 0.06 dB
+     * (first order) or 0.3 dB (second) below it. It sits ahead of the
+     * shaper: the harmonics ADAA generates droop far less than its linear
+     * path, so lifting its output would overshoot them. Indexed by ADAA order.
+     */
+    static constexpr double droopCompensation[3] = { 0.0, 0.15204777232440012, 0.48270618449307295 };
+
+    /** One ADAA input through the compensation shelf (one sample of delay) */
+    double emphasise(double x, double c)
+    {
+        const double out = (1.0 + 2.0 * c) * e1 - c * (x + e2);
+        e2 = e1;
+        e1 = x;
+        return out;
+    }
+
+    /** Transfer function (same as processSample(), post-gain) */
+    static double transfer(double x)
     {
-        for (int i = 0; i < numSamples; ++i)
+        return x > 0.0 ? -std::expm1(-x) : x / (1.0 + x * x);
+    }
+
+    /** Slope of transfer(), continuous at the origin (1 from both sides) */
+    static double derivative(double x)
+    {
+        if (x > 0.0)
+            return std::exp(-x);
+
+        const double denominator = 1.0 + x * x;
+        return (1.0 - x * x) / (denominator * denominator);
+    }
+
+    /** First antiderivative, zero at the origin */
+    static double antiderivative1(double x)
+    {
+        return x > 0.0 ? x + std::expm1(-x) : 0.5 * std::log1p(x * x);
+    }
+
+    /** Second antiderivative, zero at the origin */
+    static double antiderivative2(double x)
+    {
+        if (x > 0.0)
+            return 0.5 * x * x - x - std::expm1(-x);
+
+        return 0.5 * (x * std::log1p(x * x) - 2.0 * x + 2.0 * std::atan(x));
+    }
+
+    /**
+     * First order: y = (F1(x) - F1(x1)) / (x - x1), i.e. the mean of f over
+     * the segment between consecutive inputs. Falls back to f at the
+     * midpoint when the segment is too short to divide by.
+     */
+    void processBlockADAA1(FloatType* buffer, int numSamples, FloatType gain, FloatType gainStep)
+    {
+        constexpr double c = droopCompensation[1];
+
+        for (int i = 0; i < numSamples; ++i, gain += gainStep)
         {
-            buffer[i] = processSample(buffer[i], drive, stageMult);
+            const double x = emphasise(static_cast<double>(buffer[i] * gain), c);
+            const double ad = antiderivative1(x);
+
+            const double y = illConditioned(x, x1) ? transfer(0.5 * (x + x1))
+                                                   : (ad - ad1) / (x - x1);
+            x1 = x;
+            ad1 = ad;
+            buffer[i] = static_cast<FloatType>(y);
         }
     }
 
-private:
+    /** Divided difference of F2 with a midpoint fallback (uses cached F2 values) */
+    static double dividedDifference2(double x, double adX, double xPrev, double adPrev)
+    {
+        return illConditioned(x, xPrev) ? antiderivative1(0.5 * (x + xPrev))
+                                        : (adX - adPrev) / (x - xPrev);
+    }
+
+    /**
+     * Second order (Bilbao et al. 2017, with the fallbacks from Chowdhury's
+     * practical ADAA notes): the second divided difference of F2 over three
+     * consecutive inputs. When x and x2 nearly coincide the outer difference
+     * is replaced by its limit, 2 (F1(x) - d0) / (x - x1), and by f(x1) when
+     * all three do.
+     */
+    void processBlockADAA2(FloatType* buffer, int numSamples, FloatType gain, FloatType gainStep)
+    {
+        constexpr double c = droopCompensation[2];
+
+        for (int i = 0; i < numSamples; ++i, gain += gainStep)
+        {
+            const double x = emphasise(static_cast<double>(buffer[i] * gain), c);
+            const double ad = antiderivative2(x);
+            const double d0 = dividedDifference2(x, ad, x1, ad1);
+
+            double y;
+            if (illConditioned(x, x2))
+            {
+                y = illConditioned(x, x1)
+                        ? transfer(x1)
+                        : (2.0 / (x - x1)) * (antiderivative1(x) - d0);
+            }
+            else
+            {
+                y = (2.0 / (x - x2)) * (d0 - d1);
+            }
+
+            x2 = x1;
+            x1 = x;
+            ad1 = ad;
+            d1 = d0;
+            buffer[i] = static_cast<FloatType>(y);
+        }
+    }
+
+    FloatType inputGain = unityDriveGain;    // Gain the last block ended on
+    FloatType targetGain = unityDriveGain;   // Gain the next block ramps to
+    bool snapToTarget = true;   // No audio since reset(): jump instead of ramping
+    float lastDriveDb = 0.0f;
+    float lastStageMult = 1.0f;
+    const BasicShaperTable<FloatType>* table = nullptr;    // Lookup table in use, or null for the closed form
+
+    // ADAA state: previous inputs, antiderivative at x1, last divided difference,
+    // and the last two inputs to the droop compensation shelf
+    int adaaOrder = 0;
+    double x1 = 0.0, x2 = 0.0;
+    double ad1 = 0.0;
+    double d1 = 0.0;
+    double e1 = 0.0, e2 = 0.0;
 };
+
+using SanguinovaEngine = BasicSanguinovaEngine<float>;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include "Simd.h"
+
+/**
+ * ShaperTable - Cubic-interpolated lookup table for a transfer function
+ *
+ * Covers [-Range, Range] in uniform segments of 1 / SegmentsPerUnit. Each
+ * segment stores the cubic Hermite polynomial through the function's values
+ * and slopes at its two ends, so the curve and its slope are continuous
+ * everywhere, and a kink that sits on a segment boundary (x = 0 is one) is
+ * reproduced exactly.
+ *
+ * Coefficients are stored one array per power of t, so a simd::Vec of
+ * inputs costs one index computation, four gathers and three multiply-adds.
+ * Inputs outside the range are clamped to its ends: callers that see larger
+ * values supply their own tails (see SanguinovaEngine). NaN reads as 0, so
+ * it can never index outside the table.
+ *
+ * FloatType (float or double) is the coefficient type; the polynomials are
+ * derived in double. Building allocates, so do it off the audio thread.
+ */
+template <typename FloatType>
+class BasicShaperTable
+{
+public:
+    static constexpr int Range = 18;
+    static constexpr int SegmentsPerUnit = 32;
+    static constexpr int NumSegments = 2 * Range * SegmentsPerUnit;
+
+    /**
+     * @param function The transfer function, double -> double
+     * @param derivative Its first derivative
+     */
+    template <typename Function, typename Derivative>
+    BasicShaperTable(Function&& function, Derivative&& derivative)
+    {
+        for (auto& c : coefficients)
+            c.assign(static_cast<size_t>(NumSegments), FloatType(0));
+
+        const double h = 1.0 / SegmentsPerUnit;
+
+        for (int segment = 0; segment < NumSegments; ++segment)
+        {
+            const double x0 = -Range + segment * h;
+            const double x1 = x0 + h;
+            const double y0 = function(x0), y1 = function(x1);
+            const double d0 = derivative(x0) * h, d1 = derivative(x1) * h;
+
+            // Hermite basis in powers of t = (x - x0) / h
+            const auto index = static_cast<size_t>(segment);
+            coefficients[0][index] = static_cast<FloatType>(y0);
+            coefficients[1][index] = static_cast<FloatType>(d0);
+            coefficients[2][index] = static_cast<FloatType>(3.0 * (y1 - y0) - 2.0 * d0 - d1);
+            coefficients[3][index] = static_cast<FloatType>(2.0 * (y0 - y1) + d0 + d1);
+        }
+    }
+
+    /** Interpolated value at x (float, double, or a simd::Vec of either), clamped to the range; NaN reads x = 0 */
+    template <typename T>
+    T process(T x) const
+    {
+        // NaN fails every comparison, so this is the one lane that is not kept. It must not
+        // reach the index: min/max pass it through on some backends, and converting it is UB
+        const T ordered = simd::select(simd::greaterThan(simd::abs(x), T(FloatType(-1))), x, T(FloatType(0)));
+
+        const T range = static_cast<FloatType>(Range);
+        const T scaled = simd::min(simd::max(ordered, -range), range) * T(static_cast<FloatType>(SegmentsPerUnit));
+
+        // Segment and fraction are split before offsetting to the table start, so t keeps
+        // every bit of a small x (scaling by a power of two is exact, and so is scaled - k)
+        const T k = simd::min(simd::roundNearest(scaled - T(FloatType(0.5))), T(static_cast<FloatType>(NumSegments / 2 - 1)));
+        const T t = scaled - k;
+        const T index = k + T(static_cast<FloatType>(NumSegments / 2));
+
+        const T c0 = simd::gather(coefficients[0].data(), index);
+        const T c1 = simd::gather(coefficients[1].data(), index);
+        const T c2 = simd::gather(coefficients[2].data(), index);
+        const T c3 = simd::gather(coefficients[3].data(), index);
+
+        return simd::mulAdd(simd::mulAdd(simd::mulAdd(c3, t, c2), t, c1), t, c0);
+    }
+
+private:
+    std::array<std::vector<FloatType>, 4> coefficients;   // c0 + t * (c1 + t * (c2 + t * c3)) per segment
+};
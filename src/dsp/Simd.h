@@ -0,0 +1,610 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__AVX2__) && defined(__FMA__)
+  #include <immintrin.h>
+  #define SANGUINOVA_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define SANGUINOVA_SIMD_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #include <arm_neon.h>
+  #define SANGUINOVA_SIMD_NEON 1
+#endif
+
+/**
+ * simd - Minimal portable SIMD vector
+ *
+ * Thin wrapper over AVX2, SSE2 or NEON (scalar fallback otherwise) that
+ * provides just the operations our DSP kernels need, for float and double
+ * lanes. Lane count is fixed at compile time by the target instruction set
+ * (a double vector holds half as many lanes), so kernels should always step
+ * by Vec<T>::size.
+ *
+ * Comparisons return a lane mask (all bits set where true) that is consumed
+ * by select(), which keeps the waveshaper kernels branch-free. anyTrue()
+ * reduces a mask for the rare branch that skips work for a whole vector.
+ */
+namespace simd
+{
+
+template <typename T>
+struct Vec;
+
+//==============================================================================
+#if SANGUINOVA_SIMD_AVX2
+
+template <>
+struct Vec<float>
+{
+    static constexpr int size = 8;
+    __m256 v;
+
+    Vec() = default;
+    Vec(__m256 x) : v(x) {}
+    Vec(float x) : v(_mm256_set1_ps(x)) {}
+
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    /** Loads p[0], p[-1], ... p[-(size-1)] into lanes 0..size-1 */
+    static Vec loadReversed(const float* p)
+    {
+        return _mm256_permutevar8x32_ps(_mm256_loadu_ps(p - (size - 1)), _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return _mm256_add_ps(a.v, b.v); }
+    friend Vec operator-(Vec a, Vec b) { return _mm256_sub_ps(a.v, b.v); }
+    friend Vec operator*(Vec a, Vec b) { return _mm256_mul_ps(a.v, b.v); }
+    friend Vec operator/(Vec a, Vec b) { return _mm256_div_ps(a.v, b.v); }
+    friend Vec operator-(Vec a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+};
+
+inline Vec<float> min(Vec<float> a, Vec<float> b) { return _mm256_min_ps(a.v, b.v); }
+inline Vec<float> max(Vec<float> a, Vec<float> b) { return _mm256_max_ps(a.v, b.v); }
+inline Vec<float> abs(Vec<float> a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline Vec<float> mulAdd(Vec<float> a, Vec<float> b, Vec<float> c) { return _mm256_fmadd_ps(a.v, b.v, c.v); }
+inline Vec<float> greaterThan(Vec<float> a, Vec<float> b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+inline Vec<float> select(Vec<float> mask, Vec<float> a, Vec<float> b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+inline Vec<float> roundNearest(Vec<float> a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline bool anyTrue(Vec<float> mask) { return _mm256_movemask_ps(mask.v) != 0; }
+
+/** table[index] per lane; index holds non-negative integral values */
+inline Vec<float> gather(const float* table, Vec<float> index)
+{
+    // The masked form with a zeroed source: same instruction, and GCC doesn't flag the undefined one
+    return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), table, _mm256_cvttps_epi32(index.v),
+                                    _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+}
+
+inline float sum(Vec<float> a)
+{
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_shuffle_ps(x, x, 1)));
+}
+
+/** 2^n for integral-valued n in the normal exponent range */
+inline Vec<float> pow2i(Vec<float> n)
+{
+    auto bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n.v), _mm256_set1_epi32(127)), 23);
+    return _mm256_castsi256_ps(bits);
+}
+
+template <>
+struct Vec<double>
+{
+    static constexpr int size = 4;
+    __m256d v;
+
+    Vec() = default;
+    Vec(__m256d x) : v(x) {}
+    Vec(double x) : v(_mm256_set1_pd(x)) {}
+
+    static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    /** Loads p[0], p[-1], ... p[-(size-1)] into lanes 0..size-1 */
+    static Vec loadReversed(const double* p)
+    {
+        return _mm256_permute4x64_pd(_mm256_loadu_pd(p - (size - 1)), _MM_SHUFFLE(0, 1, 2, 3));
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return _mm256_add_pd(a.v, b.v); }
+    friend Vec operator-(Vec a, Vec b) { return _mm256_sub_pd(a.v, b.v); }
+    friend Vec operator*(Vec a, Vec b) { return _mm256_mul_pd(a.v, b.v); }
+    friend Vec operator/(Vec a, Vec b) { return _mm256_div_pd(a.v, b.v); }
+    friend Vec operator-(Vec a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+};
+
+inline Vec<double> min(Vec<double> a, Vec<double> b) { return _mm256_min_pd(a.v, b.v); }
+inline Vec<double> max(Vec<double> a, Vec<double> b) { return _mm256_max_pd(a.v, b.v); }
+inline Vec<double> abs(Vec<double> a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+inline Vec<double> mulAdd(Vec<double> a, Vec<double> b, Vec<double> c) { return _mm256_fmadd_pd(a.v, b.v, c.v); }
+inline Vec<double> greaterThan(Vec<double> a, Vec<double> b) { return _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ); }
+inline Vec<double> select(Vec<double> mask, Vec<double> a, Vec<double> b) { return _mm256_blendv_pd(b.v, a.v, mask.v); }
+inline Vec<double> roundNearest(Vec<double> a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline bool anyTrue(Vec<double> mask) { return _mm256_movemask_pd(mask.v) != 0; }
+
+/** table[index] per lane; index holds non-negative integral values */
+inline Vec<double> gather(const double* table, Vec<double> index)
+{
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table, _mm256_cvttpd_epi32(index.v),
+                                    _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+}
+
+inline double sum(Vec<double> a)
+{
+    __m128d x = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+}
+
+/** 2^n for integral-valued n in the normal exponent range */
+inline Vec<double> pow2i(Vec<double> n)
+{
+    auto exponents = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n.v));
+    auto bits = _mm256_slli_epi64(_mm256_add_epi64(exponents, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_castsi256_pd(bits);
+}
+
+//==============================================================================
+#elif SANGUINOVA_SIMD_SSE2
+
+template <>
+struct Vec<float>
+{
+    static constexpr int size = 4;
+    __m128 v;
+
+    Vec() = default;
+    Vec(__m128 x) : v(x) {}
+    Vec(float x) : v(_mm_set1_ps(x)) {}
+
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+
+    /** Loads p[0], p[-1], ... p[-(size-1)] into lanes 0..size-1 */
+    static Vec loadReversed(const float* p)
+    {
+        __m128 x = _mm_loadu_ps(p - (size - 1));
+        return _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return _mm_add_ps(a.v, b.v); }
+    friend Vec operator-(Vec a, Vec b) { return _mm_sub_ps(a.v, b.v); }
+    friend Vec operator*(Vec a, Vec b) { return _mm_mul_ps(a.v, b.v); }
+    friend Vec operator/(Vec a, Vec b) { return _mm_div_ps(a.v, b.v); }
+    friend Vec operator-(Vec a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+};
+
+inline Vec<float> min(Vec<float> a, Vec<float> b) { return _mm_min_ps(a.v, b.v); }
+inline Vec<float> max(Vec<float> a, Vec<float> b) { return _mm_max_ps(a.v, b.v); }
+inline Vec<float> abs(Vec<float> a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline Vec<float> mulAdd(Vec<float> a, Vec<float> b, Vec<float> c) { return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v); }
+inline Vec<float> greaterThan(Vec<float> a, Vec<float> b) { return _mm_cmpgt_ps(a.v, b.v); }
+
+inline Vec<float> select(Vec<float> mask, Vec<float> a, Vec<float> b)
+{
+    return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+inline Vec<float> roundNearest(Vec<float> a)
+{
+    // Valid for |a| < 2^31, which covers every caller (exp arguments are clamped)
+    return _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v));
+}
+
+inline bool anyTrue(Vec<float> mask) { return _mm_movemask_ps(mask.v) != 0; }
+
+/** table[index] per lane; index holds non-negative integral values */
+inline Vec<float> gather(const float* table, Vec<float> index)
+{
+    alignas(16) int32_t i[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(i), _mm_cvttps_epi32(index.v));
+    return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+}
+
+inline float sum(Vec<float> a)
+{
+    __m128 x = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+    return _mm_cvtss_f32(_mm_add_ss(x, _mm_shuffle_ps(x, x, 1)));
+}
+
+/** 2^n for integral-valued n in the normal exponent range */
+inline Vec<float> pow2i(Vec<float> n)
+{
+    auto bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n.v), _mm_set1_epi32(127)), 23);
+    return _mm_castsi128_ps(bits);
+}
+
+template <>
+struct Vec<double>
+{
+    static constexpr int size = 2;
+    __m128d v;
+
+    Vec() = default;
+    Vec(__m128d x) : v(x) {}
+    Vec(double x) : v(_mm_set1_pd(x)) {}
+
+    static Vec load(const double* p) { return _mm_loadu_pd(p); }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+
+    /** Loads p[0], p[-1], ... p[-(size-1)] into lanes 0..size-1 */
+    static Vec loadReversed(const double* p)
+    {
+        __m128d x = _mm_loadu_pd(p - (size - 1));
+        return _mm_shuffle_pd(x, x, 1);
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return _mm_add_pd(a.v, b.v); }
+    friend Vec operator-(Vec a, Vec b) { return _mm_sub_pd(a.v, b.v); }
+    friend Vec operator*(Vec a, Vec b) { return _mm_mul_pd(a.v, b.v); }
+    friend Vec operator/(Vec a, Vec b) { return _mm_div_pd(a.v, b.v); }
+    friend Vec operator-(Vec a) { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+};
+
+inline Vec<double> min(Vec<double> a, Vec<double> b) { return _mm_min_pd(a.v, b.v); }
+inline Vec<double> max(Vec<double> a, Vec<double> b) { return _mm_max_pd(a.v, b.v); }
+inline Vec<double> abs(Vec<double> a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+inline Vec<double> mulAdd(Vec<double> a, Vec<double> b, Vec<double> c) { return _mm_add_pd(_mm_mul_pd(a.v, b.v), c.v); }
+inline Vec<double> greaterThan(Vec<double> a, Vec<double> b) { return _mm_cmpgt_pd(a.v, b.v); }
+
+inline Vec<double> select(Vec<double> mask, Vec<double> a, Vec<double> b)
+{
+    return _mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v));
+}
+
+inline Vec<double> roundNearest(Vec<double> a)
+{
+    // Valid for |a| < 2^31, like the float version
+    return _mm_cvtepi32_pd(_mm_cvtpd_epi32(a.v));
+}
+
+inline bool anyTrue(Vec<double> mask) { return _mm_movemask_pd(mask.v) != 0; }
+
+/** table[index] per lane; index holds non-negative integral values */
+inline Vec<double> gather(const double* table, Vec<double> index)
+{
+    const __m128i i = _mm_cvttpd_epi32(index.v);
+    return _mm_setr_pd(table[_mm_cvtsi128_si32(i)], table[_mm_cvtsi128_si32(_mm_srli_si128(i, 4))]);
+}
+
+inline double sum(Vec<double> a)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(a.v, _mm_unpackhi_pd(a.v, a.v)));
+}
+
+/** 2^n for integral-valued n in the normal exponent range */
+inline Vec<double> pow2i(Vec<double> n)
+{
+    // The biased exponent is positive, so zero-extending it to 64 bits is enough
+    auto biased = _mm_add_epi32(_mm_cvtpd_epi32(n.v), _mm_set1_epi32(1023));
+    auto bits = _mm_slli_epi64(_mm_unpacklo_epi32(biased, _mm_setzero_si128()), 52);
+    return _mm_castsi128_pd(bits);
+}
+
+//==============================================================================
+#elif SANGUINOVA_SIMD_NEON
+
+template <>
+struct Vec<float>
+{
+    static constexpr int size = 4;
+    float32x4_t v;
+
+    Vec() = default;
+    Vec(float32x4_t x) : v(x) {}
+    Vec(float x) : v(vdupq_n_f32(x)) {}
+
+    static Vec load(const float* p) { return vld1q_f32(p); }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    /** Loads p[0], p[-1], ... p[-(size-1)] into lanes 0..size-1 */
+    static Vec loadReversed(const float* p)
+    {
+        float32x4_t x = vrev64q_f32(vld1q_f32(p - (size - 1)));
+        return vextq_f32(x, x, 2);
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return vaddq_f32(a.v, b.v); }
+    friend Vec operator-(Vec a, Vec b) { return vsubq_f32(a.v, b.v); }
+    friend Vec operator*(Vec a, Vec b) { return vmulq_f32(a.v, b.v); }
+    friend Vec operator/(Vec a, Vec b) { return vdivq_f32(a.v, b.v); }
+    friend Vec operator-(Vec a) { return vnegq_f32(a.v); }
+};
+
+inline Vec<float> min(Vec<float> a, Vec<float> b) { return vminq_f32(a.v, b.v); }
+inline Vec<float> max(Vec<float> a, Vec<float> b) { return vmaxq_f32(a.v, b.v); }
+inline Vec<float> abs(Vec<float> a) { return vabsq_f32(a.v); }
+inline Vec<float> mulAdd(Vec<float> a, Vec<float> b, Vec<float> c) { return vfmaq_f32(c.v, a.v, b.v); }
+inline Vec<float> greaterThan(Vec<float> a, Vec<float> b) { return vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v)); }
+inline Vec<float> select(Vec<float> mask, Vec<float> a, Vec<float> b) { return vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v); }
+inline Vec<float> roundNearest(Vec<float> a) { return vrndnq_f32(a.v); }
+inline float sum(Vec<float> a) { return vaddvq_f32(a.v); }
+inline bool anyTrue(Vec<float> mask) { return vmaxvq_u32(vreinterpretq_u32_f32(mask.v)) != 0; }
+
+/** table[index] per lane; index holds non-negative integral values */
+inline Vec<float> gather(const float* table, Vec<float> index)
+{
+    int32_t i[4];
+    vst1q_s32(i, vcvtq_s32_f32(index.v));
+    const float values[4] = { table[i[0]], table[i[1]], table[i[2]], table[i[3]] };
+    return vld1q_f32(values);
+}
+
+/** 2^n for integral-valued n in the normal exponent range */
+inline Vec<float> pow2i(Vec<float> n)
+{
+    auto bits = vshlq_n_s32(vaddq_s32(vcvtnq_s32_f32(n.v), vdupq_n_s32(127)), 23);
+    return vreinterpretq_f32_s32(bits);
+}
+
+template <>
+struct Vec<double>
+{
+    static constexpr int size = 2;
+    float64x2_t v;
+
+    Vec() = default;
+    Vec(float64x2_t x) : v(x) {}
+    Vec(double x) : v(vdupq_n_f64(x)) {}
+
+    static Vec load(const double* p) { return vld1q_f64(p); }
+    void store(double* p) const { vst1q_f64(p, v); }
+
+    /** Loads p[0], p[-1], ... p[-(size-1)] into lanes 0..size-1 */
+    static Vec loadReversed(const double* p)
+    {
+        float64x2_t x = vld1q_f64(p - (size - 1));
+        return vextq_f64(x, x, 1);
+    }
+
+    friend Vec operator+(Vec a, Vec b) { return vaddq_f64(a.v, b.v); }
+    friend Vec operator-(Vec a, Vec b) { return vsubq_f64(a.v, b.v); }
+    friend Vec operator*(Vec a, Vec b) { return vmulq_f64(a.v, b.v); }
+    friend Vec operator/(Vec a, Vec b) { return vdivq_f64(a.v, b.v); }
+    friend Vec operator-(Vec a) { return vnegq_f64(a.v); }
+};
+
+inline Vec<double> min(Vec<double> a, Vec<double> b) { return vminq_f64(a.v, b.v); }
+inline Vec<double> max(Vec<double> a, Vec<double> b) { return vmaxq_f64(a.v, b.v); }
+inline Vec<double> abs(Vec<double> a) { return vabsq_f64(a.v); }
+inline Vec<double> mulAdd(Vec<double> a, Vec<double> b, Vec<double> c) { return vfmaq_f64(c.v, a.v, b.v); }
+inline Vec<double> greaterThan(Vec<double> a, Vec<double> b) { return vreinterpretq_f64_u64(vcgtq_f64(a.v, b.v)); }
+inline Vec<double> select(Vec<double> mask, Vec<double> a, Vec<double> b) { return vbslq_f64(vreinterpretq_u64_f64(mask.v), a.v, b.v); }
+inline Vec<double> roundNearest(Vec<double> a) { return vrndnq_f64(a.v); }
+inline double sum(Vec<double> a) { return vaddvq_f64(a.v); }
+inline bool anyTrue(Vec<double> mask) { return vmaxvq_u32(vreinterpretq_u32_f64(mask.v)) != 0; }
+
+/** table[index] per lane; index holds non-negative integral values */
+inline Vec<double> gather(const double* table, Vec<double> index)
+{
+    int64_t i[2];
+    vst1q_s64(i, vcvtq_s64_f64(index.v));
+    const double values[2] = { table[i[0]], table[i[1]] };
+    return vld1q_f64(values);
+}
+
+/** 2^n for integral-valued n in the normal exponent range */
+inline Vec<double> pow2i(Vec<double> n)
+{
+    auto bits = vshlq_n_s64(vaddq_s64(vcvtnq_s64_f64(n.v), vdupq_n_s64(1023)), 52);
+    return vreinterpretq_f64_s64(bits);
+}
+
+//==============================================================================
+#else
+
+template <>
+struct Vec<float>
+{
+    static constexpr int size = 1;
+    float v;
+
+    Vec() = default;
+    Vec(float x) : v(x) {}
+
+    static Vec load(const float* p) { return *p; }
+    void store(float* p) const { *p = v; }
+    static Vec loadReversed(const float* p) { return *p; }
+
+    friend Vec operator+(Vec a, Vec b) { return a.v + b.v; }
+    friend Vec operator-(Vec a, Vec b) { return a.v - b.v; }
+    friend Vec operator*(Vec a, Vec b) { return a.v * b.v; }
+    friend Vec operator/(Vec a, Vec b) { return a.v / b.v; }
+    friend Vec operator-(Vec a) { return -a.v; }
+};
+
+inline Vec<float> min(Vec<float> a, Vec<float> b) { return std::min(a.v, b.v); }
+inline Vec<float> max(Vec<float> a, Vec<float> b) { return std::max(a.v, b.v); }
+inline Vec<float> abs(Vec<float> a) { return std::fabs(a.v); }
+inline Vec<float> mulAdd(Vec<float> a, Vec<float> b, Vec<float> c) { return a.v * b.v + c.v; }
+inline Vec<float> greaterThan(Vec<float> a, Vec<float> b) { return a.v > b.v ? 1.0f : 0.0f; }
+inline Vec<float> select(Vec<float> mask, Vec<float> a, Vec<float> b) { return mask.v != 0.0f ? a : b; }
+inline Vec<float> roundNearest(Vec<float> a) { return std::nearbyint(a.v); }
+inline float sum(Vec<float> a) { return a.v; }
+inline bool anyTrue(Vec<float> mask) { return mask.v != 0.0f; }
+inline Vec<float> gather(const float* table, Vec<float> index) { return table[static_cast<int>(index.v)]; }
+
+inline Vec<float> pow2i(Vec<float> n)
+{
+    auto bits = static_cast<uint32_t>(static_cast<int32_t>(n.v) + 127) << 23;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+template <>
+struct Vec<double>
+{
+    static constexpr int size = 1;
+    double v;
+
+    Vec() = default;
+    Vec(double x) : v(x) {}
+
+    static Vec load(const double* p) { return *p; }
+    void store(double* p) const { *p = v; }
+    static Vec loadReversed(const double* p) { return *p; }
+
+    friend Vec operator+(Vec a, Vec b) { return a.v + b.v; }
+    friend Vec operator-(Vec a, Vec b) { return a.v - b.v; }
+    friend Vec operator*(Vec a, Vec b) { return a.v * b.v; }
+    friend Vec operator/(Vec a, Vec b) { return a.v / b.v; }
+    friend Vec operator-(Vec a) { return -a.v; }
+};
+
+inline Vec<double> min(Vec<double> a, Vec<double> b) { return std::min(a.v, b.v); }
+inline Vec<double> max(Vec<double> a, Vec<double> b) { return std::max(a.v, b.v); }
+inline Vec<double> abs(Vec<double> a) { return std::fabs(a.v); }
+inline Vec<double> mulAdd(Vec<double> a, Vec<double> b, Vec<double> c) { return a.v * b.v + c.v; }
+inline Vec<double> greaterThan(Vec<double> a, Vec<double> b) { return a.v > b.v ? 1.0 : 0.0; }
+inline Vec<double> select(Vec<double> mask, Vec<double> a, Vec<double> b) { return mask.v != 0.0 ? a : b; }
+inline Vec<double> roundNearest(Vec<double> a) { return std::nearbyint(a.v); }
+inline double sum(Vec<double> a) { return a.v; }
+inline bool anyTrue(Vec<double> mask) { return mask.v != 0.0; }
+inline Vec<double> gather(const double* table, Vec<double> index) { return table[static_cast<int>(index.v)]; }
+
+inline Vec<double> pow2i(Vec<double> n)
+{
+    auto bits = static_cast<uint64_t>(static_cast<int64_t>(n.v) + 1023) << 52;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+#endif
+
+//==============================================================================
+// Scalar overloads, so generic kernels can be instantiated for plain floats
+// and doubles (block tails, reference paths) with bit-for-bit the same algorithm.
+
+inline float min(float a, float b) { return std::min(a, b); }
+inline float max(float a, float b) { return std::max(a, b); }
+inline float abs(float a) { return std::fabs(a); }
+inline float mulAdd(float a, float b, float c) { return a * b + c; }
+inline bool greaterThan(float a, float b) { return a > b; }
+inline float select(bool mask, float a, float b) { return mask ? a : b; }
+inline float roundNearest(float a) { return std::nearbyint(a); }
+inline bool anyTrue(bool mask) { return mask; }
+inline float gather(const float* table, float index) { return table[static_cast<int>(index)]; }
+
+inline float pow2i(float n)
+{
+    auto bits = static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline double min(double a, double b) { return std::min(a, b); }
+inline double max(double a, double b) { return std::max(a, b); }
+inline double abs(double a) { return std::fabs(a); }
+inline double mulAdd(double a, double b, double c) { return a * b + c; }
+inline bool greaterThan(double a, double b) { return a > b; }
+inline double select(bool mask, double a, double b) { return mask ? a : b; }
+inline double roundNearest(double a) { return std::nearbyint(a); }
+inline double gather(const double* table, double index) { return table[static_cast<int>(index)]; }
+
+inline double pow2i(double n)
+{
+    auto bits = static_cast<uint64_t>(static_cast<int64_t>(n) + 1023) << 52;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//==============================================================================
+// Generic access for kernels templated on the sample type. A "frame" is one
+// SampleType worth of scalars: a single sample, or one sample per lane when
+// channels are interleaved into a Vec. ScalarType is the float or double
+// underneath, which is what block buffers hold.
+
+template <typename T>
+struct ScalarTypeOf { using type = T; };
+
+template <typename T>
+struct ScalarTypeOf<Vec<T>> { using type = T; };
+
+template <typename T>
+using ScalarType = typename ScalarTypeOf<T>::type;
+
+template <typename T>
+constexpr int lanes = T::size;
+
+template <>
+constexpr int lanes<float> = 1;
+
+template <>
+constexpr int lanes<double> = 1;
+
+template <typename T>
+inline T load(const ScalarType<T>* p) { return T::load(p); }
+
+template <>
+inline float load<float>(const float* p) { return *p; }
+
+template <>
+inline double load<double>(const double* p) { return *p; }
+
+template <typename T>
+inline void store(Vec<T> v, T* p) { v.store(p); }
+
+inline void store(float v, float* p) { *p = v; }
+inline void store(double v, double* p) { *p = v; }
+
+/** Largest magnitude across the lanes of a frame */
+inline float peak(float v) { return std::fabs(v); }
+inline double peak(double v) { return std::fabs(v); }
+
+template <typename T>
+inline T peak(Vec<T> v)
+{
+    T values[Vec<T>::size];
+    abs(v).store(values);
+    return *std::max_element(values, values + Vec<T>::size);
+}
+
+/** Largest magnitude in a block of samples: vectors over the bulk, scalar tail */
+template <typename T>
+inline T peak(const T* data, int numValues)
+{
+    using V = Vec<T>;
+
+    V largest(T(0));
+    int i = 0;
+    for (; i + V::size <= numValues; i += V::size)
+        largest = max(largest, abs(V::load(data + i)));
+
+    T result = peak(largest);
+    for (; i < numValues; ++i)
+        result = std::max(result, std::fabs(data[i]));
+    return result;
+}
+
+/** Sum of squares of a block of samples: vectors over the bulk, scalar tail */
+template <typename T>
+inline T sumOfSquares(const T* data, int numValues)
+{
+    using V = Vec<T>;
+
+    V total(T(0));
+    int i = 0;
+    for (; i + V::size <= numValues; i += V::size)
+    {
+        const V x = V::load(data + i);
+        total = mulAdd(x, x, total);
+    }
+
+    T result = sum(total);
+    for (; i < numValues; ++i)
+        result += data[i] * data[i];
+    return result;
+}
+
+} // namespace simd
@@ -0,0 +1,231 @@
+/**
+ * Crossover: the bands must sum back to the allpass-delayed input
+ *
+ * LP4 + HP4 of a Linkwitz-Riley split is the 2nd-order allpass at its
+ * frequency, so two bands sum to AP2(low) and three to AP2(high) AP2(low).
+ * The reference runs that allpass as a double precision biquad (the bilinear
+ * image of the analog prototype, as the TPT sections are). Through the whole
+ * strip at unity drive and a level where the shaper is linear, every band
+ * sees the same chain, so the band sum must equal the full band strip fed
+ * the allpassed input, with the FIR running over lanes or per channel.
+ */
+
+#include "TestHarness.h"
+#include "dsp/ChannelStrip.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+
+constexpr double sampleRate = 48000.0;
+constexpr double pi = 3.14159265358979323846;
+constexpr float lowCrossover = 250.0f, highCrossover = 2500.0f;
+
+/** Bands of each lane, as the processor assigns them (two bands are low and high) */
+constexpr CrossoverBand bandOrder[2][3] = { { CrossoverBand::Low, CrossoverBand::High, CrossoverBand::High },
+                                            { CrossoverBand::Low, CrossoverBand::Mid, CrossoverBand::High } };
+
+/** (s^2 - sqrt2 s + 1) / (s^2 + sqrt2 s + 1) through the bilinear transform prewarped to the cutoff */
+class ReferenceAllpass
+{
+public:
+    explicit ReferenceAllpass(double cutoffHz)
+    {
+        const double g = std::tan(pi * cutoffHz / sampleRate);
+        const double k = std::sqrt(2.0);
+        const double a0 = 1.0 + k * g + g * g;
+        a1 = (2.0 * g * g - 2.0) / a0;
+        a2 = (1.0 - k * g + g * g) / a0;
+    }
+
+    /** Numerator is the denominator reversed: a2, a1, 1 */
+    double process(double input)
+    {
+        const double output = a2 * input + z1;
+        z1 = a1 * input - a1 * output + z2;
+        z2 = input - a2 * output;
+        return output;
+    }
+
+private:
+    double a1 = 0.0, a2 = 0.0, z1 = 0.0, z2 = 0.0;
+};
+
+std::vector<double> allpassed(const std::vector<double>& input, int numBands)
+{
+    ReferenceAllpass low(lowCrossover), high(highCrossover);
+    std::vector<double> output(input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+        output[i] = numBands == 3 ? high.process(low.process(input[i])) : low.process(input[i]);
+    return output;
+}
+
+std::vector<double> noise(int length, double amplitude, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(-amplitude, amplitude);
+
+    std::vector<double> samples(static_cast<size_t>(length));
+    for (auto& sample : samples)
+        sample = distribution(generator);
+    return samples;
+}
+
+/** Error power relative to the expected signal, in dB */
+double errorDb(const std::vector<double>& actual, const std::vector<double>& expected)
+{
+    double error = 0.0, power = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        error += (actual[i] - expected[i]) * (actual[i] - expected[i]);
+        power += expected[i] * expected[i];
+    }
+    return 10.0 * std::log10(error / power + 1.0e-30);
+}
+
+/** Sum of every band of the crossover, one band per lane */
+template <typename FloatType>
+std::vector<double> crossoverSum(const std::vector<double>& input, int numBands)
+{
+    using Vec = simd::Vec<FloatType>;
+    constexpr int lanes = Vec::size;
+    const int length = static_cast<int>(input.size());
+
+    std::vector<double> sum(input.size(), 0.0);
+    std::vector<FloatType> frames(static_cast<size_t>(length * lanes));
+
+    // Fewer lanes than bands (the scalar backend) take several passes
+    for (int first = 0; first < numBands; first += lanes)
+    {
+        CrossoverBand laneBands[lanes];
+        for (int lane = 0; lane < lanes; ++lane)
+            laneBands[lane] = bandOrder[numBands == 3 ? 1 : 0][std::min(first + lane, numBands - 1)];
+
+        BasicCrossover<Vec> crossover;
+        crossover.prepare(static_cast<float>(sampleRate));
+        crossover.setBands(numBands, laneBands);
+        crossover.setFrequencies(lowCrossover, highCrossover);
+
+        for (int i = 0; i < length; ++i)
+            for (int lane = 0; lane < lanes; ++lane)
+                frames[static_cast<size_t>(i * lanes + lane)] = static_cast<FloatType>(input[static_cast<size_t>(i)]);
+
+        crossover.processBlock(frames.data(), length);
+
+        for (int i = 0; i < length; ++i)
+            for (int lane = 0; lane < lanes && first + lane < numBands; ++lane)
+                sum[static_cast<size_t>(i)] += frames[static_cast<size_t>(i * lanes + lane)];
+    }
+
+    return sum;
+}
+
+/**
+ * Stereo through ChannelStrips at unity drive, numBands lanes per channel
+ * laid out band-major over as many strips as it takes, as the processor
+ * does, then summed back into the two channels
+ */
+template <typename FloatType>
+std::vector<std::vector<double>> stripSum(const std::vector<std::vector<double>>& input, int numBands, int factor, bool live)
+{
+    using Strip = BasicChannelStrip<FloatType>;
+    constexpr int numChannels = 2, blockSize = 256;
+    const int numLanes = numChannels * numBands;
+    const int length = static_cast<int>(input[0].size());
+
+    std::vector<Strip> strips(static_cast<size_t>((numLanes + Strip::MaxChannels - 1) / Strip::MaxChannels));
+    for (size_t s = 0; s < strips.size(); ++s)
+    {
+        CrossoverBand bands[Strip::MaxChannels];
+        for (int lane = 0; lane < Strip::MaxChannels; ++lane)
+        {
+            const int wetLane = static_cast<int>(s) * Strip::MaxChannels + lane;
+            bands[lane] = bandOrder[numBands == 3 ? 1 : 0][std::min(wetLane / numChannels, numBands - 1)];
+        }
+
+        auto& strip = strips[s];
+        strip.prepare(sampleRate, blockSize);
+        strip.setBands(numBands, bands);
+        strip.setCrossover(lowCrossover, highCrossover);
+        strip.setParameters(6000.0f, 0.3f, 16000.0f, 0.0f, 1.0f);
+        strip.setAntiAliasing(factor, live, 0);
+    }
+
+    std::vector<std::vector<FloatType>> lanes(static_cast<size_t>(numLanes), std::vector<FloatType>(static_cast<size_t>(length)));
+    for (int lane = 0; lane < numLanes; ++lane)
+        for (int i = 0; i < length; ++i)
+            lanes[static_cast<size_t>(lane)][static_cast<size_t>(i)] = static_cast<FloatType>(input[static_cast<size_t>(lane % numChannels)][static_cast<size_t>(i)]);
+
+    for (int start = 0; start < length; start += blockSize)
+    {
+        const int count = std::min(blockSize, length - start);
+        for (int first = 0, s = 0; first < numLanes; first += Strip::MaxChannels, ++s)
+        {
+            FloatType* channels[Strip::MaxChannels];
+            const int numStripChannels = std::min(Strip::MaxChannels, numLanes - first);
+            for (int ch = 0; ch < numStripChannels; ++ch)
+                channels[ch] = lanes[static_cast<size_t>(first + ch)].data() + start;
+
+            strips[static_cast<size_t>(s)].process(channels, numStripChannels, count, SVFMode::LowPass);
+        }
+    }
+
+    std::vector<std::vector<double>> sum(numChannels, std::vector<double>(static_cast<size_t>(length), 0.0));
+    for (int lane = 0; lane < numLanes; ++lane)
+        for (int i = 0; i < length; ++i)
+            sum[static_cast<size_t>(lane % numChannels)][static_cast<size_t>(i)] += lanes[static_cast<size_t>(lane)][static_cast<size_t>(i)];
+    return sum;
+}
+
+/** Worst channel error of the multiband strip sum against the full band strip on the allpassed input */
+template <typename FloatType>
+double worstStripErrorDb(int numBands, int factor, bool live)
+{
+    // -100 dBFS: the shaper's curvature stays some 100 dB under the signal
+    constexpr int length = 4096;
+    const std::vector<std::vector<double>> input { noise(length, 1.0e-5, 3), noise(length, 1.0e-5, 4) };
+
+    const auto bands = stripSum<FloatType>(input, numBands, factor, live);
+    const auto fullBand = stripSum<FloatType>({ allpassed(input[0], numBands), allpassed(input[1], numBands) }, 1, factor, live);
+
+    return std::max(errorDb(bands[0], fullBand[0]), errorDb(bands[1], fullBand[1]));
+}
+
+} // namespace
+
+SANGUINOVA_TEST(crossover, floatBandsSumToTheAllpassedInput)
+{
+    const auto input = noise(8192, 0.5, 1);
+    for (const int numBands : { 2, 3 })
+        EXPECT_LESS_EQUAL(errorDb(crossoverSum<float>(input, numBands), allpassed(input, numBands)), -120.0);
+}
+
+SANGUINOVA_TEST(crossover, doubleBandsSumToTheAllpassedInput)
+{
+    const auto input = noise(8192, 0.5, 2);
+    for (const int numBands : { 2, 3 })
+        EXPECT_LESS_EQUAL(errorDb(crossoverSum<double>(input, numBands), allpassed(input, numBands)), -250.0);
+}
+
+SANGUINOVA_TEST(crossover, stripBandsAtUnityDriveSumToTheAllpassedFullBand)
+{
+    // Stereo with three bands runs the FIR over lanes where a vector holds
+    // enough of them, two bands per channel mostly run it planar.
+    // Double measures -106 dB, the shaper's curvature. Float measures -61 dB:
+    // at this level 1 - exp(-x) is only good to an ulp of 1 (6e-8).
+    constexpr double floatLimitDb = -55.0, doubleLimitDb = -100.0;
+
+    for (const int numBands : { 2, 3 })
+    {
+        EXPECT_LESS_EQUAL(worstStripErrorDb<float>(numBands, 4, true), floatLimitDb);
+        EXPECT_LESS_EQUAL(worstStripErrorDb<double>(numBands, 4, true), doubleLimitDb);
+
+        for (const int factor : { 1, 2, 4, 8, 16 })
+        {
+            EXPECT_LESS_EQUAL(worstStripErrorDb<float>(numBands, factor, false), floatLimitDb);
+            EXPECT_LESS_EQUAL(worstStripErrorDb<double>(numBands, factor, false), doubleLimitDb);
+        }
+    }
+}
@@ -0,0 +1,194 @@
+/**
+ * SVFFilter: the static and per-frame cutoff paths against a double
+ * precision TPT reference
+ *
+ * The reference derives every frame's coefficients with std::tan, so it is
+ * what both block paths approximate: the static one glides its coefficients
+ * linearly, the modulated one recomputes them per frame with FastMath::tanPi
+ * and glides 1/Q.
+ */
+
+#include "TestHarness.h"
+#include "dsp/SVFFilter.h"
+
+#include <vector>
+
+namespace
+{
+
+constexpr double sampleRate = 48000.0;
+constexpr double pi = 3.14159265358979323846;
+
+/** One TPT SVF step per frame, coefficients from the cutoff and 1/Q given for that frame */
+class ReferenceSVF
+{
+public:
+    double process(double input, double frequency, double k, SVFMode mode)
+    {
+        const double g = std::tan(pi * std::min(std::max(frequency, 20.0), 0.49 * sampleRate) / sampleRate);
+        const double a1 = 1.0 / (1.0 + g * (g + k));
+        const double a2 = g * a1;
+        const double a3 = g * a2;
+
+        const double v3 = input - s2;
+        const double v1 = a1 * s1 + a2 * v3;
+        const double v2 = s2 + a2 * s1 + a3 * v3;
+        s1 = 2.0 * v1 - s1;
+        s2 = 2.0 * v2 - s2;
+
+        return mode == SVFMode::LowPass ? v2 : mode == SVFMode::HighPass ? input - k * v1 - v2 : v1;
+    }
+
+private:
+    double s1 = 0.0, s2 = 0.0;
+};
+
+/** 1/Q for the filter's resonance control (0.1-1.0 maps to Q 0.5-10) */
+double inverseQ(float resonance)
+{
+    return 1.0 / (0.5 + resonance * 9.5);
+}
+
+std::vector<float> testSignal(int length)
+{
+    std::vector<float> samples(static_cast<size_t>(length));
+    for (int i = 0; i < length; ++i)
+        samples[static_cast<size_t>(i)] = static_cast<float>(0.5 * std::sin(0.05 * i) + 0.3 * std::sin(0.71 * i + 1.0));
+    return samples;
+}
+
+/** Exponential sweep from 40 Hz to 16 kHz and back, one cutoff per frame */
+std::vector<float> sweep(int length)
+{
+    std::vector<float> cutoff(static_cast<size_t>(length));
+    for (int i = 0; i < length; ++i)
+    {
+        const double position = 1.0 - std::abs(2.0 * i / (length - 1) - 1.0);
+        cutoff[static_cast<size_t>(i)] = static_cast<float>(40.0 * std::pow(400.0, position));
+    }
+    return cutoff;
+}
+
+} // namespace
+
+SANGUINOVA_TEST(filter, lowPassGainAtCutoffIsQ)
+{
+    // A prewarped TPT lowpass has |H| = Q exactly at its cutoff
+    for (const float resonance : { 0.0f, 0.5f, 1.0f })
+    {
+        SVFFilter filter;
+        filter.prepare(static_cast<float>(sampleRate));
+        filter.setParameters(1000.0f, resonance);
+
+        std::vector<float> samples(static_cast<size_t>(48000));
+        for (size_t i = 0; i < samples.size(); ++i)
+            samples[i] = static_cast<float>(std::sin(2.0 * pi * 1000.0 * static_cast<double>(i) / sampleRate));
+
+        filter.processBlock<SVFMode::LowPass>(samples.data(), static_cast<int>(samples.size()));
+
+        // Amplitude over the last second's whole periods, after the ring-in
+        double power = 0.0;
+        for (size_t i = 24000; i < samples.size(); ++i)
+            power += static_cast<double>(samples[i]) * samples[i];
+        const double amplitude = std::sqrt(2.0 * power / 24000.0);
+
+        EXPECT_NEAR(amplitude, 1.0 / inverseQ(resonance), 1.0e-3 / inverseQ(resonance));
+    }
+}
+
+SANGUINOVA_TEST(filter, modulatedPathMatchesStaticAtConstantCutoff)
+{
+    const auto input = testSignal(1000);
+    const std::vector<float> cutoff(input.size(), 2500.0f);
+
+    for (const auto mode : { SVFMode::LowPass, SVFMode::HighPass, SVFMode::BandPass })
+    {
+        SVFFilter fixed, modulated;
+        fixed.prepare(static_cast<float>(sampleRate));
+        modulated.prepare(static_cast<float>(sampleRate));
+        fixed.setParameters(2500.0f, 0.7f);
+        modulated.setParameters(2500.0f, 0.7f);
+
+        auto a = input, b = input;
+        fixed.processBlock(a.data(), static_cast<int>(a.size()), mode);
+        modulated.processBlock(b.data(), cutoff.data(), static_cast<int>(b.size()), mode);
+
+        double worst = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+            worst = std::max(worst, static_cast<double>(std::abs(a[i] - b[i])));
+        EXPECT_LESS_EQUAL(worst, 2.0e-6);
+    }
+}
+
+SANGUINOVA_TEST(filter, modulatedPathTracksSweepAndResonanceGlide)
+{
+    constexpr int length = 4096, blockSize = 256;
+    const auto input = testSignal(length);
+    const auto cutoff = sweep(length);
+
+    for (const auto mode : { SVFMode::LowPass, SVFMode::HighPass, SVFMode::BandPass })
+    {
+        SVFFilter filter;
+        filter.prepare(static_cast<float>(sampleRate));
+        filter.setParameters(cutoff[0], 0.1f);
+
+        ReferenceSVF reference;
+        double k = inverseQ(0.1f);
+        double worst = 0.0;
+        auto output = input;
+
+        for (int start = 0; start < length; start += blockSize)
+        {
+            // A new resonance every block: 1/Q must glide across it, not step at its start
+            const float resonance = 0.1f + 0.8f * static_cast<float>((start / blockSize) % 2);
+            filter.setParameters(cutoff[static_cast<size_t>(start)], resonance);
+            filter.processBlock(output.data() + start, cutoff.data() + start, blockSize, mode);
+
+            const double kStep = (inverseQ(resonance) - k) / blockSize;
+            for (int i = start; i < start + blockSize; ++i)
+            {
+                k += kStep;
+                const double expected = reference.process(input[static_cast<size_t>(i)], cutoff[static_cast<size_t>(i)], k, mode);
+                worst = std::max(worst, std::abs(output[static_cast<size_t>(i)] - expected));
+            }
+            k = inverseQ(resonance);
+        }
+
+        EXPECT_LESS_EQUAL(worst, 1.0e-5);
+    }
+}
+
+SANGUINOVA_TEST(filter, laneFiltersMatchScalar)
+{
+    using Vec = simd::Vec<float>;
+    constexpr int lanes = Vec::size;
+    constexpr int length = 777;
+
+    const auto input = testSignal(length);
+    const auto cutoff = sweep(length);
+
+    // Lane c carries the signal scaled by c + 1, so every lane is distinct
+    std::vector<float> frames(static_cast<size_t>(length * lanes));
+    for (int i = 0; i < length; ++i)
+        for (int lane = 0; lane < lanes; ++lane)
+            frames[static_cast<size_t>(i * lanes + lane)] = input[static_cast<size_t>(i)] * static_cast<float>(lane + 1);
+
+    BasicSVFFilter<Vec> vectorFilter;
+    SVFFilter scalarFilter;
+    vectorFilter.prepare(static_cast<float>(sampleRate));
+    scalarFilter.prepare(static_cast<float>(sampleRate));
+    vectorFilter.setParameters(cutoff[0], 0.4f);
+    scalarFilter.setParameters(cutoff[0], 0.4f);
+
+    auto scalar = input;
+    vectorFilter.processBlock<SVFMode::BandPass>(frames.data(), cutoff.data(), length);
+    scalarFilter.processBlock<SVFMode::BandPass>(scalar.data(), cutoff.data(), length);
+
+    double worst = 0.0;
+    for (int i = 0; i < length; ++i)
+        for (int lane = 0; lane < lanes; ++lane)
+            worst = std::max(worst, static_cast<double>(std::abs(frames[static_cast<size_t>(i * lanes + lane)]
+                                                                 - scalar[static_cast<size_t>(i)] * static_cast<float>(lane + 1))));
+
+    EXPECT_LESS_EQUAL(worst, 1.0e-5);
+}
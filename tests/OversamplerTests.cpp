@@ -0,0 +1,176 @@
+/**
+ * Oversampler: the per-factor FIR designs
+ *
+ * Every factor must round-trip with unity gain across the passband, delay by
+ * exactly the latency it reports, and keep the images of an upsampled tone
+ * down to what its design was chosen for.
+ */
+
+#include "TestHarness.h"
+#include "dsp/Oversampler.h"
+
+#include <vector>
+
+namespace
+{
+
+constexpr double pi = 3.14159265358979323846;
+constexpr int factors[] = { 2, 4, 8, 16 };
+
+/** Amplitude and phase of a steady sine at the given normalised frequency (cycles per sample) */
+struct Tone
+{
+    double amplitude;
+    double phase;
+};
+
+Tone measureTone(const std::vector<double>& samples, size_t start, double frequency)
+{
+    double re = 0.0, im = 0.0;
+    for (size_t i = start; i < samples.size(); ++i)
+    {
+        const double angle = 2.0 * pi * frequency * static_cast<double>(i);
+        re += samples[i] * std::cos(angle);
+        im += samples[i] * std::sin(angle);
+    }
+
+    const double count = static_cast<double>(samples.size() - start);
+    return { 2.0 * std::sqrt(re * re + im * im) / count, std::atan2(re, im) };
+}
+
+/** A whole number of periods from start to end, so measureTone() does not leak */
+std::vector<double> sine(double frequency, int length)
+{
+    std::vector<double> samples(static_cast<size_t>(length));
+    for (int i = 0; i < length; ++i)
+        samples[static_cast<size_t>(i)] = 0.5 * std::sin(2.0 * pi * frequency * i);
+    return samples;
+}
+
+/** Round trip of a sine at the given frequency through up- and downsampling */
+Tone roundTrip(Oversampler& oversampler, double frequency, int length, int settle)
+{
+    const auto input = sine(frequency, length);
+    std::vector<float> buffer(input.begin(), input.end());
+
+    oversampler.reset();
+    oversampler.processBlock(buffer.data(), length, [](float*, int) {});
+
+    return measureTone(std::vector<double>(buffer.begin(), buffer.end()), static_cast<size_t>(settle), frequency);
+}
+
+} // namespace
+
+SANGUINOVA_TEST(oversampler, passbandRoundTripIsFlatAndDelayedByTheReportedLatency)
+{
+    constexpr int length = 8192, settle = 1024;
+
+    for (const int factor : factors)
+    {
+        Oversampler oversampler;
+        oversampler.prepare(length);
+        oversampler.setFactor(factor);
+        const double latency = oversampler.getLatencyInSamples();
+        EXPECT_NEAR(latency, Oversampler::filterOrder(factor) - 1, 0.0);
+
+        // Bins that fit a whole number of periods in the measured span, up to 0.16 of the rate
+        for (const int bin : { 16, 256, 700, 1146 })
+        {
+            const double frequency = static_cast<double>(bin) / (length - settle);
+            const auto tone = roundTrip(oversampler, frequency, length, settle);
+
+            EXPECT_NEAR(20.0 * std::log10(tone.amplitude / 0.5), 0.0, 0.3);
+
+            // A pure delay of `latency` samples lags the phase by 2 pi f latency
+            const double lag = std::remainder(-tone.phase - 2.0 * pi * frequency * latency, 2.0 * pi);
+            EXPECT_NEAR(lag, 0.0, 1.0e-3);
+        }
+    }
+}
+
+SANGUINOVA_TEST(oversampler, upsampledImagesMeetEachDesign)
+{
+    // About 5 dB above what each design measures. The 8x and 16x limits fail
+    // with the 2x/4x design (beta 7, 32 taps), which measures -101 and -91 dB.
+    constexpr double imageLimitDb[] = { -115.0, -95.0, -103.0, -110.0 };
+    constexpr int length = 4096, settle = 512;
+
+    for (size_t index = 0; index < std::size(factors); ++index)
+    {
+        const int factor = factors[index];
+
+        Oversampler oversampler;
+        oversampler.setFactor(factor);
+
+        // At the passband edge (0.16 of the rate) the images come closest to the transition band
+        const double frequency = 573.0 / (length - settle);
+        const auto input = sine(frequency, length);
+        std::vector<float> in(input.begin(), input.end());
+        std::vector<float> up(static_cast<size_t>(length * factor));
+        oversampler.upsampleBlock(in.data(), up.data(), length);
+
+        std::vector<double> upsampled(up.begin(), up.end());
+        const auto signal = measureTone(upsampled, static_cast<size_t>(settle * factor), frequency / factor);
+
+        // The first images of the zero-stuffed tone sit around each multiple of the base rate
+        double worst = -200.0;
+        for (int k = 1; k < factor; ++k)
+        {
+            for (const double image : { k - frequency, k + frequency })
+            {
+                const auto leak = measureTone(upsampled, static_cast<size_t>(settle * factor), image / factor);
+                worst = std::max(worst, 20.0 * std::log10(leak.amplitude / signal.amplitude));
+            }
+        }
+
+        EXPECT_LESS_EQUAL(worst, imageLimitDb[index]);
+    }
+}
+
+SANGUINOVA_TEST(oversampler, laneOversamplerMatchesPlanar)
+{
+    using Vec = simd::Vec<float>;
+    constexpr int lanes = Vec::size;
+    constexpr int length = 999;
+
+    for (const int factor : factors)
+    {
+        // Lane c carries a tone of its own, so crossed lanes would show
+        std::vector<float> frames(static_cast<size_t>(length * lanes));
+        std::vector<std::vector<float>> planar(lanes, std::vector<float>(static_cast<size_t>(length)));
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const auto tone = sine(0.01 * (lane + 1), length);
+            for (int i = 0; i < length; ++i)
+                planar[static_cast<size_t>(lane)][static_cast<size_t>(i)] = frames[static_cast<size_t>(i * lanes + lane)]
+                    = static_cast<float>(tone[static_cast<size_t>(i)]);
+        }
+
+        // A shaper between the halves, so the oversampled frames matter too
+        auto shape = [](float* data, int count) {
+            for (int i = 0; i < count; ++i)
+                data[i] = std::tanh(4.0f * data[i]);
+        };
+
+        BasicOversampler<Vec> laneOversampler;
+        laneOversampler.prepare(256);
+        laneOversampler.setFactor(factor);
+        laneOversampler.processBlock(frames.data(), length, [&](float* data, int numFrames) { shape(data, numFrames * lanes); });
+
+        double worst = 0.0;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            Oversampler oversampler;
+            oversampler.prepare(256);
+            oversampler.setFactor(factor);
+            auto& expected = planar[static_cast<size_t>(lane)];
+            oversampler.processBlock(expected.data(), length, shape);
+
+            for (int i = 0; i < length; ++i)
+                worst = std::max(worst, static_cast<double>(std::abs(frames[static_cast<size_t>(i * lanes + lane)] - expected[static_cast<size_t>(i)])));
+        }
+
+        // Same taps, summed in a different order
+        EXPECT_LESS_EQUAL(worst, 1.0e-6);
+    }
+}
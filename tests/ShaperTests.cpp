@@ -0,0 +1,79 @@
+/**
+ * ShaperTable: the lookup-table shaper against the closed form
+ *
+ * The table must track the transfer function to within float resolution
+ * over its range and beyond (where the engine supplies the tails), and no
+ * input, NaN included, may index outside it.
+ */
+
+#include "TestHarness.h"
+#include "dsp/SanguinovaEngine.h"
+
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+double transfer(double x)
+{
+    return x > 0.0 ? 1.0 - std::exp(-x) : x / (1.0 + x * x);
+}
+
+/** Largest |table - transfer| through the engine's block path at 0 dB drive, over inputs past the range */
+template <typename FloatType>
+double worstTableError()
+{
+    std::vector<FloatType> samples;
+    for (double x = -40.0; x <= 40.0; x += 1.0 / 1024.0)
+        samples.push_back(static_cast<FloatType>(x / BasicSanguinovaEngine<FloatType>::unityDriveGain));
+    const auto input = samples;
+
+    BasicSanguinovaEngine<FloatType> engine;
+    engine.setLookupTable(true);
+    engine.processBlock(samples.data(), static_cast<int>(samples.size()));
+
+    double worst = 0.0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const double x = static_cast<double>(input[i]) * BasicSanguinovaEngine<FloatType>::unityDriveGain;
+        worst = std::max(worst, std::abs(static_cast<double>(samples[i]) - transfer(x)));
+    }
+    return worst;
+}
+
+} // namespace
+
+SANGUINOVA_TEST(shaper, floatTableMatchesTransfer)
+{
+    // The closed form itself is off by 6e-8 in float
+    EXPECT_LESS_EQUAL(worstTableError<float>(), 1.0e-7);
+}
+
+SANGUINOVA_TEST(shaper, doubleTableMatchesTransfer)
+{
+    EXPECT_LESS_EQUAL(worstTableError<double>(), 1.0e-7);
+}
+
+SANGUINOVA_TEST(shaper, nanAndInfinityStayInsideTheTable)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    const auto& table = SanguinovaEngine::lookupTable();
+
+    EXPECT_NEAR(table.process(nan), 0.0, 0.0);
+    EXPECT_NEAR(table.process(inf), table.process(1.0e6f), 0.0);
+    EXPECT_NEAR(table.process(-inf), table.process(-1.0e6f), 0.0);
+
+    // NaN in some lanes must not disturb the others
+    using Vec = simd::Vec<float>;
+    float lanes[Vec::size];
+    for (int lane = 0; lane < Vec::size; ++lane)
+        lanes[lane] = lane % 2 == 0 ? nan : 0.25f * static_cast<float>(lane);
+
+    float shaped[Vec::size];
+    table.process(Vec::load(lanes)).store(shaped);
+
+    for (int lane = 0; lane < Vec::size; ++lane)
+        EXPECT_NEAR(shaped[lane], lane % 2 == 0 ? 0.0f : table.process(lanes[lane]), 0.0);
+}
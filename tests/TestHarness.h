@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * TestHarness - The few pieces the DSP tests need, without a framework
+ *
+ * Tests register themselves under a group with SANGUINOVA_TEST. The runner
+ * (TestMain.cpp) runs every test of the groups named on its command line,
+ * or all of them, and exits non-zero if any check failed; CTest runs one
+ * group per test so failures show up by name.
+ *
+ * Checks record the failure and carry on, so one run reports every
+ * mismatch in a test rather than the first.
+ */
+namespace TestHarness
+{
+
+struct TestCase
+{
+    const char* group;
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<TestCase>& registry()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int& failureCount()
+{
+    static int failures = 0;
+    return failures;
+}
+
+struct Registration
+{
+    Registration(const char* group, const char* name, void (*run)())
+    {
+        registry().push_back({ group, name, run });
+    }
+};
+
+inline void fail(const char* file, int line, const std::string& message)
+{
+    std::fprintf(stderr, "    %s:%d: %s\n", file, line, message.c_str());
+    ++failureCount();
+}
+
+/** |actual - expected| <= tolerance; NaN never passes */
+inline bool isNear(double actual, double expected, double tolerance)
+{
+    return std::abs(actual - expected) <= tolerance;
+}
+
+} // namespace TestHarness
+
+#define SANGUINOVA_TEST_NAME2(a, b) a##b
+#define SANGUINOVA_TEST_NAME(a, b) SANGUINOVA_TEST_NAME2(a, b)
+
+#define SANGUINOVA_TEST(group, name)                                                                         \
+    static void name();                                                                                      \
+    static const TestHarness::Registration SANGUINOVA_TEST_NAME(name, Registration) { #group, #name, &name }; \
+    static void name()
+
+#define EXPECT_TRUE(condition)                                                         \
+    do {                                                                               \
+        if (! (condition))                                                             \
+            TestHarness::fail(__FILE__, __LINE__, "expected " #condition);            \
+    } while (false)
+
+#define EXPECT_NEAR(actual, expected, tolerance)                                                          \
+    do {                                                                                                  \
+        const double actualValue = static_cast<double>(actual);                                          \
+        const double expectedValue = static_cast<double>(expected);                                      \
+        if (! TestHarness::isNear(actualValue, expectedValue, static_cast<double>(tolerance)))           \
+            TestHarness::fail(__FILE__, __LINE__, #actual " = " + std::to_string(actualValue)             \
+                                                      + ", expected " + std::to_string(expectedValue)     \
+                                                      + " within " + std::to_string(tolerance));         \
+    } while (false)
+
+#define EXPECT_LESS_EQUAL(actual, limit)                                                                  \
+    do {                                                                                                  \
+        const double actualValue = static_cast<double>(actual);                                          \
+        if (! (actualValue <= static_cast<double>(limit)))                                               \
+            TestHarness::fail(__FILE__, __LINE__, #actual " = " + std::to_string(actualValue)             \
+                                                      + ", expected at most " + std::to_string(limit));   \
+    } while (false)
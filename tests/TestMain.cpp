@@ -0,0 +1,44 @@
+/**
+ * sanguinova_tests - Runner for the header-only DSP tests
+ *
+ *   sanguinova_tests [group ...]
+ *
+ * Runs every registered test, or only those of the named groups, and exits
+ * with status 1 if any check failed.
+ */
+
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cstring>
+
+int main(int argc, char* argv[])
+{
+    const auto selected = [&](const char* group) {
+        return argc < 2 || std::any_of(argv + 1, argv + argc, [group](const char* arg) { return std::strcmp(arg, group) == 0; });
+    };
+
+    int ran = 0;
+    for (const auto& test : TestHarness::registry())
+    {
+        if (! selected(test.group))
+            continue;
+
+        const int failuresBefore = TestHarness::failureCount();
+        std::fprintf(stderr, "  %s.%s\n", test.group, test.name);
+        test.run();
+        ++ran;
+
+        if (TestHarness::failureCount() != failuresBefore)
+            std::fprintf(stderr, "  %s.%s FAILED\n", test.group, test.name);
+    }
+
+    if (ran == 0)
+    {
+        std::fprintf(stderr, "sanguinova_tests: no tests selected\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "sanguinova_tests: %d tests, %d failed checks\n", ran, TestHarness::failureCount());
+    return TestHarness::failureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,854 @@
+/**
+ * sanguinova_analyze - Aliasing, distortion and passband measurements for the
+ * oversampler / shaper variants, gated against a high-order reference
+ *
+ * Each variant (oversampling factor x quality x ADAA order, plus the lookup
+ * table shaper without ADAA) runs the shaping chain, Oversampler or
+ * IIROversampler around SanguinovaEngine's block path.
+ *
+ * - Stepped sines on exact FFT bins, across every drive and stage setting,
+ *   give aliasing (energy off the harmonic grid), THD+N and the harmonic
+ *   magnitudes. The same tones go through a double-precision reference at the
+ *   same factor, and each variant is scored against it.
+ * - A low-level log sweep, deconvolved, gives passband ripple and the -3 dB
+ *   bandwidth of the whole chain (oversampling filters plus ADAA droop).
+ * - The variant's own cost is timed with CycleClock, so every pass/fail line
+ *   sits next to a ns/sample figure that compares with sanguinova_bench.
+ * - Table variants also report the largest difference between the table and
+ *   the closed-form shaper over a dense input sweep.
+ * - The multiband crossover is checked on its own: the impulse responses of
+ *   its bands, split side by side in SIMD lanes, must sum to the cascade of
+ *   the splits' 2nd-order allpasses (flat magnitude, phase-coherent bands).
+ *
+ *   sanguinova_analyze [--quick] [--output=<file>] [--sample-rate=48000]
+ *                      [--oversampling=1,2,4,8,16] [--quality=linear-phase,live]
+ *                      [--adaa=0,1,2] [--shaper=closed-form,table]
+ *                      [--frequencies=100,1000,3000,5000,7000]
+ *                      [--drives=0,12,24] [--stages=0,1,3,7] [--passband-hz=<hz>]
+ *                      [--alias-tolerance-db=6] [--alias-floor-db=-100]
+ *                      [--max-harmonic-error-db=-30] [--max-ripple-db=1]
+ *                      [--max-table-error-db=-120] [--bands=2,3]
+ *                      [--max-crossover-error-db=-80]
+ *
+ * --stages takes bitmasks of the Ignition stages (1 = 2x, 2 = 5x, 4 = 10x).
+ * Exits with status 1 if any variant fails its gate.
+ */
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include "dsp/Oversampler.h"
+#include "dsp/IIROversampler.h"
+#include "dsp/SanguinovaEngine.h"
+#include "dsp/Crossover.h"
+#include "diagnostics/CycleClock.h"
+
+#include <complex>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+
+//==============================================================================
+struct Options
+{
+    double sampleRate = 48000.0;
+    juce::Array<int> oversampling { 1, 2, 4, 8, 16 };
+    juce::Array<bool> qualities { false, true };    // live?
+    juce::Array<int> adaaOrders { 0, 1, 2 };
+    juce::Array<bool> shapers { false, true };      // lookup table?
+    juce::Array<double> frequencies { 100.0, 1000.0, 3000.0, 5000.0, 7000.0 };
+    juce::Array<float> drives { 0.0f, 12.0f, 24.0f };
+    juce::Array<int> stageMasks { 0, 1, 3, 7 };
+    juce::Array<int> bandCounts { 2, 3 };
+
+    // Harmonics and ripple are judged up to here. The linear-phase
+    // oversampler's cutoff sits at 0.22 of the sample rate, so 0.16 keeps
+    // the default clear of its transition band.
+    double passbandHz = 0.0;
+
+    // Gates, all relative to the fundamental (dB)
+    double aliasToleranceDb = 6.0;         // Allowed aliasing above the reference
+    double aliasFloorDb = -100.0;          // Reference aliasing below this counts as this
+    double maxHarmonicErrorDb = -30.0;     // Harmonic magnitudes vs the reference
+    double maxRippleDb = 1.0;              // Peak-to-peak over the passband
+    double maxTableErrorDb = -120.0;       // Table vs closed-form shaper, re full scale
+    double maxCrossoverErrorDb = -80.0;    // Summed bands vs the ideal allpass, re unity gain
+
+    juce::File output;
+};
+
+const char* qualityName(bool live) { return live ? "live" : "linear-phase"; }
+const char* shaperName(bool table) { return table ? "table" : "closed-form"; }
+
+template <typename T>
+juce::Array<T> parseList(const juce::String& text)
+{
+    juce::Array<T> values;
+    for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+        values.add(static_cast<T>(token.trim().getDoubleValue()));
+    return values;
+}
+
+Options parseOptions(juce::ArgumentList args)
+{
+    Options options;
+
+    if (args.removeOptionIfFound("--quick"))
+    {
+        options.oversampling = { 2, 4 };
+        options.frequencies = { 1000.0, 5000.0 };
+        options.drives = { 12.0f };
+        options.stageMasks = { 0, 7 };
+    }
+
+    if (args.containsOption("--sample-rate"))
+        options.sampleRate = args.removeValueForOption("--sample-rate").getDoubleValue();
+    if (args.containsOption("--oversampling"))
+        options.oversampling = parseList<int>(args.removeValueForOption("--oversampling"));
+    if (args.containsOption("--adaa"))
+        options.adaaOrders = parseList<int>(args.removeValueForOption("--adaa"));
+    if (args.containsOption("--frequencies"))
+        options.frequencies = parseList<double>(args.removeValueForOption("--frequencies"));
+    if (args.containsOption("--drives"))
+        options.drives = parseList<float>(args.removeValueForOption("--drives"));
+    if (args.containsOption("--stages"))
+        options.stageMasks = parseList<int>(args.removeValueForOption("--stages"));
+    if (args.containsOption("--passband-hz"))
+        options.passbandHz = args.removeValueForOption("--passband-hz").getDoubleValue();
+    if (args.containsOption("--alias-tolerance-db"))
+        options.aliasToleranceDb = args.removeValueForOption("--alias-tolerance-db").getDoubleValue();
+    if (args.containsOption("--alias-floor-db"))
+        options.aliasFloorDb = args.removeValueForOption("--alias-floor-db").getDoubleValue();
+    if (args.containsOption("--max-harmonic-error-db"))
+        options.maxHarmonicErrorDb = args.removeValueForOption("--max-harmonic-error-db").getDoubleValue();
+    if (args.containsOption("--max-ripple-db"))
+        options.maxRippleDb = args.removeValueForOption("--max-ripple-db").getDoubleValue();
+    if (args.containsOption("--bands"))
+        options.bandCounts = parseList<int>(args.removeValueForOption("--bands"));
+    if (args.containsOption("--max-crossover-error-db"))
+        options.maxCrossoverErrorDb = args.removeValueForOption("--max-crossover-error-db").getDoubleValue();
+    if (args.containsOption("--max-table-error-db"))
+        options.maxTableErrorDb = args.removeValueForOption("--max-table-error-db").getDoubleValue();
+    if (args.containsOption("--output"))
+        options.output = juce::File::getCurrentWorkingDirectory().getChildFile(args.removeValueForOption("--output"));
+
+    if (args.containsOption("--quality"))
+    {
+        options.qualities.clear();
+        for (const auto& name : juce::StringArray::fromTokens(args.removeValueForOption("--quality"), ",", {}))
+            for (const bool live : { false, true })
+                if (name.trim().equalsIgnoreCase(qualityName(live)))
+                    options.qualities.add(live);
+    }
+
+    if (args.containsOption("--shaper"))
+    {
+        options.shapers.clear();
+        for (const auto& name : juce::StringArray::fromTokens(args.removeValueForOption("--shaper"), ",", {}))
+            for (const bool table : { false, true })
+                if (name.trim().equalsIgnoreCase(shaperName(table)))
+                    options.shapers.add(table);
+    }
+
+    if (options.passbandHz <= 0.0)
+        options.passbandHz = 0.16 * options.sampleRate;
+
+    return options;
+}
+
+float stageMultiplier(int mask)
+{
+    return ((mask & 1) != 0 ? 2.0f : 1.0f) * ((mask & 2) != 0 ? 5.0f : 1.0f) * ((mask & 4) != 0 ? 10.0f : 1.0f);
+}
+
+double toDb(double powerRatio)
+{
+    return 10.0 * std::log10(std::max(powerRatio, 1.0e-30));
+}
+
+//==============================================================================
+/** Real FFT with zero padding; bins 0..size/2 as power or complex values */
+class Spectrum
+{
+public:
+    explicit Spectrum(int order) : fft(order), data(static_cast<size_t>(2 << order), 0.0f) {}
+
+    int size() const { return fft.getSize(); }
+
+    void transform(const float* samples, int numSamples)
+    {
+        std::fill(data.begin(), data.end(), 0.0f);
+        std::copy_n(samples, std::min(numSamples, size()), data.begin());
+        fft.performRealOnlyForwardTransform(data.data(), true);
+    }
+
+    std::complex<double> bin(int index) const
+    {
+        return { data[static_cast<size_t>(2 * index)], data[static_cast<size_t>(2 * index + 1)] };
+    }
+
+    double power(int index) const { return std::norm(bin(index)); }
+
+private:
+    juce::dsp::FFT fft;
+    std::vector<float> data;
+};
+
+//==============================================================================
+/** The block path's transfer function, evaluated exactly in double precision */
+double referenceShape(double x)
+{
+    return x > 0.0 ? 1.0 - std::exp(-x) : x / (1.0 + x * x);
+}
+
+/**
+ * Brute-force double-precision oversampler in the style of Oversampler's
+ * design: a Kaiser-windowed sinc at four times the length, with beta raised
+ * until the stopband is past 115 dB. Slow, but it is the yardstick the real
+ * oversamplers are measured against.
+ *
+ * The cutoff follows the variant under test, so each is judged against its
+ * own passband: 0.22 of the base rate for the linear-phase FIR, 0.45 for the
+ * IIR cascade (whose first half-band stage has a 0.05 transition width).
+ */
+class ReferenceOversampler
+{
+public:
+    static constexpr int TapsPerPhase = 128;     // Four times the 2x/4x branch length
+
+    static double cutoffFor(bool live) { return live ? 0.45 : 0.22; }
+
+    ReferenceOversampler(int overFactor, double baseRateCutoff) : factor(overFactor)
+    {
+        if (factor == 1)
+            return;
+
+        constexpr double beta = 12.0;
+        const double cutoff = baseRateCutoff / factor;
+        const int length = factor * (TapsPerPhase - 1) + 1;
+        const int centre = (length - 1) / 2;
+
+        prototype.resize(static_cast<size_t>(length));
+        double sum = 0.0;
+
+        for (int i = 0; i < length; ++i)
+        {
+            const double n = static_cast<double>(i - centre);
+            const double sinc = i == centre ? 2.0 * cutoff
+                                            : std::sin(juce::MathConstants<double>::twoPi * cutoff * n) / (juce::MathConstants<double>::pi * n);
+            const double ratio = n / static_cast<double>(centre);
+            prototype[static_cast<size_t>(i)] = sinc * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / besselI0(beta);
+            sum += prototype[static_cast<size_t>(i)];
+        }
+
+        for (auto& tap : prototype)
+            tap /= sum;
+
+        // Zero-padded polyphase branches, so every phase is one TapsPerPhase dot product
+        branches.assign(static_cast<size_t>(factor * TapsPerPhase), 0.0);
+        for (int tap = 0; tap < length; ++tap)
+            branches[static_cast<size_t>((tap % factor) * TapsPerPhase + tap / factor)] = factor * prototype[static_cast<size_t>(tap)];
+
+        // Mirrored histories, as in Oversampler: windows never wrap
+        upsampleHistory.assign(static_cast<size_t>(2 * TapsPerPhase), 0.0);
+        downsampleHistory.assign(2 * prototype.size(), 0.0);
+    }
+
+    /** Upsample, shape every oversampled sample, decimate; in place */
+    template <typename Shaper>
+    void process(double* buffer, int numSamples, Shaper&& shape)
+    {
+        if (factor == 1)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                buffer[i] = shape(buffer[i]);
+            return;
+        }
+
+        const int length = static_cast<int>(prototype.size());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            upsampleIndex = (upsampleIndex == 0 ? TapsPerPhase : upsampleIndex) - 1;
+            upsampleHistory[static_cast<size_t>(upsampleIndex)] = buffer[i];
+            upsampleHistory[static_cast<size_t>(upsampleIndex + TapsPerPhase)] = buffer[i];
+            const double* window = upsampleHistory.data() + upsampleIndex;
+
+            for (int phase = 0; phase < factor; ++phase)
+            {
+                const double* branch = branches.data() + phase * TapsPerPhase;
+                const double shaped = shape(std::inner_product(window, window + TapsPerPhase, branch, 0.0));
+
+                downsampleIndex = (downsampleIndex == 0 ? length : downsampleIndex) - 1;
+                downsampleHistory[static_cast<size_t>(downsampleIndex)] = shaped;
+                downsampleHistory[static_cast<size_t>(downsampleIndex + length)] = shaped;
+            }
+
+            const double* history = downsampleHistory.data() + downsampleIndex;
+            buffer[i] = std::inner_product(prototype.begin(), prototype.end(), history, 0.0);
+        }
+    }
+
+private:
+    static double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 200 && term > 1.0e-17 * sum; ++k)
+        {
+            term *= (x / 2.0) * (x / 2.0) / (static_cast<double>(k) * static_cast<double>(k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    int factor;
+    std::vector<double> prototype, branches;
+    std::vector<double> upsampleHistory, downsampleHistory;   // Newest sample first
+    int upsampleIndex = 0;
+    int downsampleIndex = 0;
+};
+
+//==============================================================================
+/** One variant under test: the production oversampler around the engine's block path */
+class Chain
+{
+public:
+    static constexpr int blockSize = 512;
+
+    Chain(int factor, bool isLive, int adaaOrder, bool lookupTable) : live(isLive)
+    {
+        fir.prepare(blockSize);
+        iir.prepare(blockSize);
+        fir.setFactor(factor);
+        iir.setFactor(factor);
+        engine.setAntiderivativeOrder(adaaOrder);
+        engine.setLookupTable(lookupTable);
+    }
+
+    void reset(float driveDb, float stageMult)
+    {
+        fir.reset();
+        iir.reset();
+        engine.reset();
+        engine.setParameters(driveDb, stageMult);
+    }
+
+    void process(float* buffer, int numSamples)
+    {
+        auto shape = [this](float* data, int count) { engine.processBlock(data, count); };
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int count = std::min(blockSize, numSamples - start);
+            if (live)
+                iir.processBlock(buffer + start, count, shape);
+            else
+                fir.processBlock(buffer + start, count, shape);
+        }
+    }
+
+private:
+    bool live;
+    Oversampler fir;
+    IIROversampler iir;
+    SanguinovaEngine engine;
+};
+
+//==============================================================================
+/** What one stepped sine leaves in the spectrum, relative to its fundamental */
+struct ToneMetrics
+{
+    double aliasingDb = 0.0;              // Everything off the harmonic grid
+    double thdnDb = 0.0;                  // Everything but the fundamental
+    std::vector<double> harmonics;        // |H_n| / |H_1| for n = 2, 3, ... inside the passband
+};
+
+class ToneAnalyser
+{
+public:
+    static constexpr int fftOrder = 14;
+    static constexpr int settleSamples = 4096;   // Oversampler and ADAA transients
+
+    explicit ToneAnalyser(const Options& o) : options(o), spectrum(fftOrder) {}
+
+    int fftSize() const { return spectrum.size(); }
+    int totalSamples() const { return settleSamples + fftSize(); }
+
+    /**
+     * Odd FFT bin nearest the requested frequency. The tone then repeats
+     * exactly within the window (no leakage, no window needed) and no
+     * aliased harmonic can land on a harmonic bin.
+     */
+    int toneBin(double frequency) const
+    {
+        const int bin = juce::roundToInt(frequency * fftSize() / options.sampleRate);
+        return std::max(1, bin | 1);
+    }
+
+    double binFrequency(int bin) const { return bin * options.sampleRate / fftSize(); }
+
+    /** -6 dBFS sine on the given bin, settling lead-in included */
+    std::vector<double> tone(int bin) const
+    {
+        std::vector<double> samples(static_cast<size_t>(totalSamples()));
+        for (size_t i = 0; i < samples.size(); ++i)
+            samples[i] = 0.5 * std::sin(juce::MathConstants<double>::twoPi * bin * static_cast<double>(i) / fftSize());
+        return samples;
+    }
+
+    /** Metrics of the last fftSize() samples of a processed tone */
+    template <typename Sample>
+    ToneMetrics analyse(const std::vector<Sample>& processed, int bin)
+    {
+        std::vector<float> window(processed.end() - fftSize(), processed.end());
+        spectrum.transform(window.data(), fftSize());
+
+        const int lastBin = std::min(fftSize() / 2, static_cast<int>(std::min(20000.0, 0.45 * options.sampleRate) * fftSize() / options.sampleRate));
+        const int passbandBin = static_cast<int>(options.passbandHz * fftSize() / options.sampleRate);
+        const double fundamental = spectrum.power(bin);
+
+        ToneMetrics metrics;
+        double harmonicPower = 0.0, otherPower = 0.0;
+
+        for (int b = 1; b <= lastBin; ++b)
+        {
+            if (b % bin != 0)
+                otherPower += spectrum.power(b);
+            else if (b != bin)
+                harmonicPower += spectrum.power(b);
+
+            if (b % bin == 0 && b != bin && b <= passbandBin)
+                metrics.harmonics.push_back(std::sqrt(spectrum.power(b) / fundamental));
+        }
+
+        metrics.aliasingDb = toDb(otherPower / fundamental);
+        metrics.thdnDb = toDb((harmonicPower + otherPower) / fundamental);
+        return metrics;
+    }
+
+private:
+    const Options& options;
+    Spectrum spectrum;
+};
+
+/** Energy of the harmonic magnitude differences, relative to the fundamental */
+double harmonicErrorDb(const ToneMetrics& measured, const ToneMetrics& reference)
+{
+    double error = 0.0;
+    for (size_t n = 0; n < std::min(measured.harmonics.size(), reference.harmonics.size()); ++n)
+        error += juce::square(measured.harmonics[n] - reference.harmonics[n]);
+    return toDb(error);
+}
+
+//==============================================================================
+/**
+ * Small-signal magnitude response from a -60 dBFS exponential sweep, divided
+ * out of the output spectrum. The shaper is all but linear at that level, so
+ * this is the oversampling filters plus any ADAA high-frequency droop.
+ */
+struct Response
+{
+    double rippleDb = 0.0;        // Peak-to-peak from 20 Hz to the passband edge
+    double bandwidthHz = 0.0;     // Where the response first falls 3 dB below 1 kHz
+};
+
+Response measureResponse(Chain& chain, const Options& options)
+{
+    constexpr int fftOrder = 16;
+    constexpr int sweepLength = 1 << 15;
+    Spectrum spectrum(fftOrder);
+    const int size = spectrum.size();
+
+    const double startHz = 10.0, endHz = 0.49 * options.sampleRate;
+    const double duration = sweepLength / options.sampleRate;
+    const double rate = std::log(endHz / startHz);
+
+    std::vector<float> sweep(static_cast<size_t>(size), 0.0f);
+    for (int i = 0; i < sweepLength; ++i)
+    {
+        const double t = i / options.sampleRate;
+        const double phase = juce::MathConstants<double>::twoPi * startHz * duration / rate * (std::exp(t * rate / duration) - 1.0);
+        sweep[static_cast<size_t>(i)] = static_cast<float>(1.0e-3 * std::sin(phase));
+    }
+
+    // The tail past the sweep collects the filters' ring-out
+    std::vector<float> output(sweep);
+    chain.reset(0.0f, 1.0f);
+    chain.process(output.data(), size);
+
+    spectrum.transform(sweep.data(), size);
+    std::vector<std::complex<double>> input(static_cast<size_t>(size / 2 + 1));
+    for (int b = 0; b <= size / 2; ++b)
+        input[static_cast<size_t>(b)] = spectrum.bin(b);
+
+    spectrum.transform(output.data(), size);
+
+    auto gainDbAt = [&](int b) { return 20.0 * std::log10(std::abs(spectrum.bin(b) / input[static_cast<size_t>(b)]) + 1.0e-30); };
+    auto binOf = [&](double hz) { return juce::roundToInt(hz * size / options.sampleRate); };
+
+    Response response;
+    double lowest = 1.0e9, highest = -1.0e9;
+    for (int b = binOf(20.0); b <= binOf(options.passbandHz); ++b)
+    {
+        lowest = std::min(lowest, gainDbAt(b));
+        highest = std::max(highest, gainDbAt(b));
+    }
+    response.rippleDb = highest - lowest;
+
+    const double reference = gainDbAt(binOf(1000.0));
+    int b = binOf(1000.0);
+    while (b < binOf(0.45 * options.sampleRate) && gainDbAt(b + 1) > reference - 3.0)
+        ++b;
+    response.bandwidthHz = b * options.sampleRate / size;
+
+    return response;
+}
+
+//==============================================================================
+struct TestPoint
+{
+    int bin;
+    float driveDb;
+    int stageMask;
+    ToneMetrics reference;
+};
+
+/** Reference metrics for every tone x drive x stage setting at one factor and quality */
+std::vector<TestPoint> measureReference(int factor, bool live, ToneAnalyser& analyser, const Options& options)
+{
+    std::vector<TestPoint> points;
+
+    for (const double frequency : options.frequencies)
+    for (const float drive : options.drives)
+    for (const int mask : options.stageMasks)
+    {
+        TestPoint point { analyser.toneBin(frequency), drive, mask, {} };
+        const double gain = SanguinovaEngine::unityDriveGain * std::pow(10.0, drive / 20.0) * stageMultiplier(mask);
+
+        auto samples = analyser.tone(point.bin);
+        ReferenceOversampler reference(factor, ReferenceOversampler::cutoffFor(live));
+        reference.process(samples.data(), static_cast<int>(samples.size()), [gain](double x) { return referenceShape(gain * x); });
+
+        point.reference = analyser.analyse(samples, point.bin);
+        points.push_back(std::move(point));
+    }
+
+    return points;
+}
+
+/**
+ * Largest difference between the lookup table and the closed-form shaper,
+ * both through the block path at 0 dB drive, over inputs well past the
+ * table's range (dB re full scale)
+ */
+double tableErrorDb()
+{
+    std::vector<float> closedForm;
+    for (double x = -40.0; x <= 40.0; x += 1.0 / 8192.0)
+        closedForm.push_back(static_cast<float>(x));
+    std::vector<float> table(closedForm);
+
+    SanguinovaEngine engine;
+    engine.setParameters(0.0f, 1.0f);
+    engine.processBlock(closedForm.data(), static_cast<int>(closedForm.size()));
+
+    engine.setLookupTable(true);
+    engine.processBlock(table.data(), static_cast<int>(table.size()));
+
+    double error = 0.0;
+    for (size_t i = 0; i < table.size(); ++i)
+        error = std::max(error, static_cast<double>(std::abs(table[i] - closedForm[i])));
+    return 20.0 * std::log10(std::max(error, 1.0e-15));
+}
+
+juce::var analyseVariant(int factor, bool live, int adaaOrder, bool lookupTable, const std::vector<TestPoint>& points,
+                         ToneAnalyser& analyser, const Options& options, bool& passed)
+{
+    Chain chain(factor, live, adaaOrder, lookupTable);
+
+    auto record = new juce::DynamicObject();
+    record->setProperty("stage", "shaper");
+    record->setProperty("variant", "factor=" + juce::String(factor) + ",quality=" + qualityName(live) + ",adaa=" + juce::String(adaaOrder)
+                                       + (lookupTable ? ",shaper=table" : ""));
+
+    double worstAliasing = -1.0e9, worstExcess = -1.0e9, worstThdn = -1.0e9, worstHarmonicError = -1.0e9;
+    uint64_t ticks = 0;
+    int64_t samplesProcessed = 0;
+    juce::Array<juce::var> pointRecords;
+
+    for (const auto& point : points)
+    {
+        const auto tone = analyser.tone(point.bin);
+        std::vector<float> samples(tone.begin(), tone.end());
+
+        chain.reset(point.driveDb, stageMultiplier(point.stageMask));
+
+        const uint64_t start = CycleClock::now();
+        chain.process(samples.data(), static_cast<int>(samples.size()));
+        ticks += CycleClock::now() - start;
+        samplesProcessed += static_cast<int64_t>(samples.size());
+
+        const auto metrics = analyser.analyse(samples, point.bin);
+        const double excess = metrics.aliasingDb - std::max(point.reference.aliasingDb, options.aliasFloorDb);
+        const double harmonicError = harmonicErrorDb(metrics, point.reference);
+
+        worstAliasing = std::max(worstAliasing, metrics.aliasingDb);
+        worstExcess = std::max(worstExcess, excess);
+        worstThdn = std::max(worstThdn, metrics.thdnDb);
+        worstHarmonicError = std::max(worstHarmonicError, harmonicError);
+
+        auto pointRecord = new juce::DynamicObject();
+        pointRecord->setProperty("frequency", analyser.binFrequency(point.bin));
+        pointRecord->setProperty("drive", point.driveDb);
+        pointRecord->setProperty("stages", point.stageMask);
+        pointRecord->setProperty("aliasingDb", metrics.aliasingDb);
+        pointRecord->setProperty("referenceAliasingDb", point.reference.aliasingDb);
+        pointRecord->setProperty("thdnDb", metrics.thdnDb);
+        pointRecord->setProperty("referenceThdnDb", point.reference.thdnDb);
+        pointRecord->setProperty("harmonicErrorDb", harmonicError);
+        pointRecords.add(juce::var(pointRecord));
+    }
+
+    const auto response = measureResponse(chain, options);
+
+    juce::StringArray failures;
+    if (worstExcess > options.aliasToleranceDb)
+        failures.add("aliasing");
+    if (worstHarmonicError > options.maxHarmonicErrorDb)
+        failures.add("harmonics");
+    if (response.rippleDb > options.maxRippleDb)
+        failures.add("ripple");
+
+    const double transferErrorDb = lookupTable ? tableErrorDb() : -300.0;
+    if (transferErrorDb > options.maxTableErrorDb)
+        failures.add("table");
+
+    const double nsPerSample = 1.0e9 * static_cast<double>(ticks) / CycleClock::ticksPerSecond() / static_cast<double>(samplesProcessed);
+
+    record->setProperty("factor", factor);
+    record->setProperty("quality", qualityName(live));
+    record->setProperty("adaa", adaaOrder);
+    record->setProperty("shaper", shaperName(lookupTable));
+    record->setProperty("nsPerSample", nsPerSample);
+    record->setProperty("aliasingDb", worstAliasing);
+    record->setProperty("aliasingExcessDb", worstExcess);
+    record->setProperty("thdnDb", worstThdn);
+    record->setProperty("harmonicErrorDb", worstHarmonicError);
+    record->setProperty("rippleDb", response.rippleDb);
+    record->setProperty("bandwidthHz", response.bandwidthHz);
+    if (lookupTable)
+        record->setProperty("tableErrorDb", transferErrorDb);
+    record->setProperty("pass", failures.isEmpty());
+    record->setProperty("failures", failures.joinIntoString(","));
+    record->setProperty("points", pointRecords);
+
+    std::cerr << "  " << record->getProperty("variant").toString()
+              << "  excess " << juce::String(worstExcess, 1) << " dB"
+              << "  harmonics " << juce::String(worstHarmonicError, 1) << " dB"
+              << "  ripple " << juce::String(response.rippleDb, 2) << " dB"
+              << (lookupTable ? "  table " + juce::String(transferErrorDb, 1) + " dB" : juce::String())
+              << "  " << juce::String(nsPerSample, 1) << " ns/sample  "
+              << (failures.isEmpty() ? juce::String("PASS") : "FAIL (" + failures.joinIntoString(", ") + ")") << std::endl;
+
+    passed = passed && failures.isEmpty();
+    return juce::var(record);
+}
+
+//==============================================================================
+/**
+ * Impulse response of every band of a crossover, each in its own lane of
+ * the production SIMD path (several passes if the bands outnumber the lanes)
+ */
+template <typename FloatType>
+std::vector<std::vector<double>> crossoverBands(int numBands, float lowHz, float highHz, double sampleRate, int length)
+{
+    using SampleType = simd::Vec<FloatType>;
+    constexpr int lanes = simd::lanes<SampleType>;
+    const CrossoverBand order[2][3] = { { CrossoverBand::Low, CrossoverBand::High, CrossoverBand::High },
+                                        { CrossoverBand::Low, CrossoverBand::Mid, CrossoverBand::High } };
+
+    std::vector<std::vector<double>> bands(static_cast<size_t>(numBands), std::vector<double>(static_cast<size_t>(length)));
+    std::vector<FloatType> frames(static_cast<size_t>(length * lanes), FloatType(0));
+
+    for (int first = 0; first < numBands; first += lanes)
+    {
+        std::array<CrossoverBand, lanes> laneBands;
+        for (int lane = 0; lane < lanes; ++lane)
+            laneBands[static_cast<size_t>(lane)] = order[numBands == 3 ? 1 : 0][std::min(first + lane, numBands - 1)];
+
+        BasicCrossover<SampleType> crossover;
+        crossover.prepare(static_cast<float>(sampleRate));
+        crossover.setBands(numBands, laneBands.data());
+        crossover.setFrequencies(lowHz, highHz);
+
+        std::fill(frames.begin(), frames.end(), FloatType(0));
+        std::fill_n(frames.begin(), lanes, FloatType(1));
+        crossover.processBlock(frames.data(), length);
+
+        for (int lane = 0; lane < lanes && first + lane < numBands; ++lane)
+            for (int i = 0; i < length; ++i)
+                bands[static_cast<size_t>(first + lane)][static_cast<size_t>(i)] = frames[static_cast<size_t>(i * lanes + lane)];
+    }
+
+    return bands;
+}
+
+/**
+ * The bilinear-transform image of the analog 2nd-order Butterworth allpass
+ * (s^2 - sqrt2 s + 1) / (s^2 + sqrt2 s + 1) at the given frequency, which is
+ * what LP4 + HP4 of one TPT split must add up to
+ */
+std::complex<double> idealAllpass(double frequencyHz, double cutoffHz, double sampleRate)
+{
+    const double g = std::tan(juce::MathConstants<double>::pi * std::min(cutoffHz, 0.49 * sampleRate) / sampleRate);
+    const std::complex<double> s(0.0, std::tan(juce::MathConstants<double>::pi * frequencyHz / sampleRate) / g);
+    const double k = std::sqrt(2.0);
+    return (s * s - k * s + 1.0) / (s * s + k * s + 1.0);
+}
+
+template <typename FloatType>
+juce::var analyseCrossover(int numBands, float lowHz, float highHz, const Options& options, bool& passed)
+{
+    constexpr int fftOrder = 16;
+    Spectrum spectrum(fftOrder);
+    const int size = spectrum.size();
+
+    const auto bands = crossoverBands<FloatType>(numBands, lowHz, highHz, options.sampleRate, size);
+
+    // Summed in double, so only the crossover's own rounding shows
+    std::vector<float> sum(static_cast<size_t>(size)), low(static_cast<size_t>(size));
+    for (size_t i = 0; i < sum.size(); ++i)
+    {
+        double total = 0.0;
+        for (const auto& band : bands)
+            total += band[i];
+        sum[i] = static_cast<float>(total);
+        low[i] = static_cast<float>(bands[0][i]);
+    }
+
+    auto binFrequency = [&](int b) { return b * options.sampleRate / size; };
+    auto binOf = [&](double hz) { return juce::roundToInt(hz * size / options.sampleRate); };
+
+    // Low band at the low crossover: -6 dB for a Linkwitz-Riley split
+    spectrum.transform(low.data(), size);
+    const double crossoverGainDb = 20.0 * std::log10(std::abs(spectrum.bin(binOf(lowHz))) + 1.0e-30);
+
+    spectrum.transform(sum.data(), size);
+
+    double worstError = 0.0, lowest = 1.0e9, highest = -1.0e9;
+    for (int b = binOf(20.0); b <= binOf(std::min(20000.0, 0.45 * options.sampleRate)); ++b)
+    {
+        auto ideal = idealAllpass(binFrequency(b), lowHz, options.sampleRate);
+        if (numBands == 3)
+            ideal *= idealAllpass(binFrequency(b), highHz, options.sampleRate);
+
+        const double magnitudeDb = 20.0 * std::log10(std::abs(spectrum.bin(b)) + 1.0e-30);
+        worstError = std::max(worstError, std::abs(spectrum.bin(b) - ideal));
+        lowest = std::min(lowest, magnitudeDb);
+        highest = std::max(highest, magnitudeDb);
+    }
+
+    const double sumErrorDb = 20.0 * std::log10(std::max(worstError, 1.0e-15));
+
+    juce::StringArray failures;
+    if (sumErrorDb > options.maxCrossoverErrorDb)
+        failures.add("summing");
+
+    auto record = new juce::DynamicObject();
+    record->setProperty("stage", "crossover");
+    record->setProperty("variant", "bands=" + juce::String(numBands) + ",low=" + juce::String(lowHz)
+                                       + (numBands == 3 ? ",high=" + juce::String(highHz) : juce::String())
+                                       + ",precision=" + (std::is_same_v<FloatType, double> ? "double" : "float"));
+    record->setProperty("bands", numBands);
+    record->setProperty("sumErrorDb", sumErrorDb);
+    record->setProperty("sumRippleDb", highest - lowest);
+    record->setProperty("crossoverGainDb", crossoverGainDb);
+    record->setProperty("pass", failures.isEmpty());
+    record->setProperty("failures", failures.joinIntoString(","));
+
+    std::cerr << "  " << record->getProperty("variant").toString()
+              << "  sum error " << juce::String(sumErrorDb, 1) << " dB"
+              << "  ripple " << juce::String(highest - lowest, 4) << " dB"
+              << "  low band at crossover " << juce::String(crossoverGainDb, 2) << " dB  "
+              << (failures.isEmpty() ? juce::String("PASS") : "FAIL (" + failures.joinIntoString(", ") + ")") << std::endl;
+
+    passed = passed && failures.isEmpty();
+    return juce::var(record);
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    const Options options = parseOptions(juce::ArgumentList(argc, argv));
+    ToneAnalyser analyser(options);
+    juce::Array<juce::var> results;
+    bool passed = true;
+
+    std::cerr << "sanguinova_analyze: " << options.sampleRate << " Hz, passband "
+              << options.passbandHz << " Hz, " << analyser.fftSize() << "-point FFT" << std::endl;
+
+    for (const int factor : options.oversampling)
+    {
+        for (const bool live : options.qualities)
+        {
+            const auto points = measureReference(factor, live, analyser, options);
+
+            // The table only replaces plain shaping: ADAA keeps its closed-form antiderivatives
+            for (const int adaaOrder : options.adaaOrders)
+                for (const bool table : options.shapers)
+                    if (! table || adaaOrder == 0)
+                        results.add(analyseVariant(factor, live, adaaOrder, table, points, analyser, options, passed));
+        }
+    }
+
+    // Crossovers at both ends of their ranges and at the defaults
+    const std::pair<float, float> crossovers[] = { { 40.0f, 1000.0f }, { 200.0f, 3000.0f }, { 1000.0f, 12000.0f } };
+
+    for (const int numBands : options.bandCounts)
+    {
+        for (const auto& [lowHz, highHz] : crossovers)
+        {
+            results.add(analyseCrossover<float>(numBands, lowHz, highHz, options, passed));
+            results.add(analyseCrossover<double>(numBands, lowHz, highHz, options, passed));
+        }
+    }
+
+    auto gates = new juce::DynamicObject();
+    gates->setProperty("aliasToleranceDb", options.aliasToleranceDb);
+    gates->setProperty("aliasFloorDb", options.aliasFloorDb);
+    gates->setProperty("maxHarmonicErrorDb", options.maxHarmonicErrorDb);
+    gates->setProperty("maxRippleDb", options.maxRippleDb);
+    gates->setProperty("maxTableErrorDb", options.maxTableErrorDb);
+    gates->setProperty("maxCrossoverErrorDb", options.maxCrossoverErrorDb);
+
+    auto report = new juce::DynamicObject();
+    report->setProperty("version", 3);   // 2: records carry "shaper"; 3: "crossover" records
+    report->setProperty("sampleRate", options.sampleRate);
+    report->setProperty("passbandHz", options.passbandHz);
+    report->setProperty("fftSize", analyser.fftSize());
+    report->setProperty("gates", juce::var(gates));
+    report->setProperty("pass", passed);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (options.output != juce::File())
+    {
+        if (! options.output.replaceWithText(json))
+        {
+            std::cerr << "sanguinova_analyze: cannot write " << options.output.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,571 @@
+/**
+ * sanguinova_bench - Headless micro-benchmarks for the DSP classes and the
+ * full processBlock() chain
+ *
+ * Every configuration is timed block by block with CycleClock and reported
+ * as one JSON record (cycles/sample, ns/sample, throughput, realtime factor
+ * and per-block latency percentiles), so two runs can be diffed directly.
+ *
+ *   sanguinova_bench [--quick] [--output=<file>] [--time-ms=<n>]
+ *                    [--suites=engine,svf,onepole,oversampler,autogain,chain,idle]
+ *                    [--block-sizes=64,512] [--sample-rates=48000]
+ *                    [--modes=lp,hp,bp] [--stages=0,1,3,7] [--mix=0,50,100]
+ *                    [--oversampling=4] [--bands=1,2,3] [--live] [--cpu-budget=100]
+ *                    [--precision=float,double]
+ *
+ * --stages takes bitmasks of the Ignition stages (1 = 2x, 2 = 5x, 4 = 10x).
+ * --bands runs the chain full-band (1) or split into 2 or 3 bands.
+ * Every suite runs once per --precision; records carry a "precision" field,
+ * so float and double results for the same variant sit side by side (the
+ * chain runs the processor with the host's double-precision path).
+ * Chain records also carry the processor's own CpuLoadMeter statistics,
+ * counting blocks over --cpu-budget (percent of real time) as overruns.
+ */
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PluginProcessor.h"
+#include "dsp/AutoGain.h"
+#include "diagnostics/CycleClock.h"
+
+#include <iostream>
+
+namespace
+{
+
+//==============================================================================
+struct Options
+{
+    juce::StringArray suites { "engine", "svf", "onepole", "oversampler", "autogain", "chain", "idle" };
+    juce::Array<int> blockSizes { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+    juce::Array<int> filterModes { 0, 1, 2 };
+    juce::Array<int> stageMasks { 0, 1, 3, 7 };
+    juce::Array<float> mixes { 0.0f, 50.0f, 100.0f };
+    juce::Array<int> oversampling { 4 };
+    juce::Array<int> bandCounts { 1, 2, 3 };
+    juce::StringArray precisions { "float", "double" };
+    bool live = false;
+    float cpuBudget = 1.0f;
+    double timePerConfigMs = 10.0;
+    juce::File output;
+};
+
+const char* const modeNames[] = { "lp", "hp", "bp" };
+
+template <typename T>
+juce::Array<T> parseList(const juce::String& text)
+{
+    juce::Array<T> values;
+    for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+        values.add(static_cast<T>(token.trim().getDoubleValue()));
+    return values;
+}
+
+Options parseOptions(juce::ArgumentList args)
+{
+    Options options;
+
+    if (args.removeOptionIfFound("--quick"))
+    {
+        options.blockSizes = { 64, 512, 4096 };
+        options.sampleRates = { 48000.0 };
+        options.stageMasks = { 0, 7 };
+        options.mixes = { 100.0f };
+        options.bandCounts = { 1, 3 };
+        options.timePerConfigMs = 5.0;
+    }
+
+    if (args.containsOption("--suites"))
+        options.suites = juce::StringArray::fromTokens(args.removeValueForOption("--suites"), ",", {});
+    if (args.containsOption("--block-sizes"))
+        options.blockSizes = parseList<int>(args.removeValueForOption("--block-sizes"));
+    if (args.containsOption("--sample-rates"))
+        options.sampleRates = parseList<double>(args.removeValueForOption("--sample-rates"));
+    if (args.containsOption("--stages"))
+        options.stageMasks = parseList<int>(args.removeValueForOption("--stages"));
+    if (args.containsOption("--mix"))
+        options.mixes = parseList<float>(args.removeValueForOption("--mix"));
+    if (args.containsOption("--oversampling"))
+        options.oversampling = parseList<int>(args.removeValueForOption("--oversampling"));
+    if (args.containsOption("--bands"))
+        options.bandCounts = parseList<int>(args.removeValueForOption("--bands"));
+    if (args.containsOption("--precision"))
+        options.precisions = juce::StringArray::fromTokens(args.removeValueForOption("--precision"), ",", {});
+    if (args.containsOption("--time-ms"))
+        options.timePerConfigMs = args.removeValueForOption("--time-ms").getDoubleValue();
+    if (args.containsOption("--cpu-budget"))
+        options.cpuBudget = args.removeValueForOption("--cpu-budget").getFloatValue() / 100.0f;
+    if (args.containsOption("--output"))
+        options.output = juce::File::getCurrentWorkingDirectory().getChildFile(args.removeValueForOption("--output"));
+
+    if (args.containsOption("--modes"))
+    {
+        options.filterModes.clear();
+        for (const auto& name : juce::StringArray::fromTokens(args.removeValueForOption("--modes"), ",", {}))
+            for (int mode = 0; mode < 3; ++mode)
+                if (name.trim().equalsIgnoreCase(modeNames[mode]))
+                    options.filterModes.add(mode);
+    }
+
+    options.live = args.removeOptionIfFound("--live");
+    return options;
+}
+
+//==============================================================================
+/** Deterministic noise, handed out in rotating windows so no two blocks repeat */
+class Signal
+{
+public:
+    explicit Signal(float amplitude)
+    {
+        juce::Random random(0x5eed);
+        for (auto& sample : samples)
+            sample = amplitude * (2.0f * random.nextFloat() - 1.0f);
+    }
+
+    const float* next(int numSamples)
+    {
+        if (position + numSamples > static_cast<int>(samples.size()))
+            position = 0;
+
+        const float* window = samples.data() + position;
+        position += numSamples;
+        return window;
+    }
+
+private:
+    std::vector<float> samples = std::vector<float>(1 << 18);
+    int position = 0;
+};
+
+//==============================================================================
+/**
+ * Time process() once per block until the time budget is spent (at least
+ * 16 blocks), after a warm-up. refill() restores the input and is not timed.
+ * warmedUp() runs between the warm-up and the first timed block, so any
+ * statistics gathered alongside can start over on the same blocks.
+ */
+template <typename Refill, typename Process, typename WarmedUp>
+juce::var measure(juce::DynamicObject::Ptr record, const Options& options, int blockSize, double sampleRate,
+                  int numChannels, Refill&& refill, Process&& process, WarmedUp&& warmedUp)
+{
+    const double ticksPerSecond = CycleClock::ticksPerSecond();
+    const uint64_t clockOverhead = CycleClock::overhead();
+    const auto budget = static_cast<uint64_t>(options.timePerConfigMs * 1.0e-3 * ticksPerSecond);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        refill();
+        process();
+    }
+
+    warmedUp();
+
+    std::vector<uint64_t> ticks;
+    uint64_t total = 0;
+
+    while ((total < budget || ticks.size() < 16) && ticks.size() < 200000)
+    {
+        refill();
+
+        const uint64_t start = CycleClock::now();
+        process();
+        const uint64_t elapsed = CycleClock::now() - start;
+
+        ticks.push_back(elapsed > clockOverhead ? elapsed - clockOverhead : 0);
+        total += ticks.back();
+    }
+
+    std::sort(ticks.begin(), ticks.end());
+
+    auto percentileNs = [&](double p)
+    {
+        const auto index = std::min(ticks.size() - 1, static_cast<size_t>(p * static_cast<double>(ticks.size())));
+        return 1.0e9 * static_cast<double>(ticks[index]) / ticksPerSecond;
+    };
+
+    const double samples = static_cast<double>(ticks.size()) * blockSize;
+    const double seconds = static_cast<double>(total) / ticksPerSecond;
+    const double medianTicks = static_cast<double>(ticks[ticks.size() / 2]);
+
+    record->setProperty("blockSize", blockSize);
+    record->setProperty("sampleRate", sampleRate);
+    record->setProperty("channels", numChannels);
+    record->setProperty("blocks", static_cast<int>(ticks.size()));
+    record->setProperty("cyclesPerSample", medianTicks / blockSize);
+    record->setProperty("nsPerSample", 1.0e9 * medianTicks / ticksPerSecond / blockSize);
+    record->setProperty("msamplesPerSecond", seconds > 0.0 ? samples / seconds * 1.0e-6 : 0.0);
+    record->setProperty("realtimeFactor", seconds > 0.0 ? samples / seconds / sampleRate : 0.0);
+
+    auto latency = new juce::DynamicObject();
+    latency->setProperty("p50", percentileNs(0.50));
+    latency->setProperty("p90", percentileNs(0.90));
+    latency->setProperty("p99", percentileNs(0.99));
+    latency->setProperty("max", percentileNs(1.0));
+    record->setProperty("latencyNs", juce::var(latency));
+
+    return juce::var(record.get());
+}
+
+template <typename FloatType>
+const char* precisionName()
+{
+    return std::is_same_v<FloatType, double> ? "double" : "float";
+}
+
+template <typename FloatType>
+juce::DynamicObject::Ptr makeRecord(const juce::String& stage, const juce::String& variant)
+{
+    juce::DynamicObject::Ptr record = new juce::DynamicObject();
+    record->setProperty("stage", stage);
+    record->setProperty("variant", variant);
+    record->setProperty("precision", precisionName<FloatType>());
+    return record;
+}
+
+/** Call suite(FloatType{}) for float and / or double, as requested */
+template <typename Suite>
+void forEachPrecision(const Options& options, Suite&& suite)
+{
+    if (options.precisions.contains("float"))
+        suite(float{});
+    if (options.precisions.contains("double"))
+        suite(double{});
+}
+
+//==============================================================================
+/** Mono DSP classes: one record per variant x block size x sample rate */
+class StageBench
+{
+public:
+    StageBench(const Options& o, juce::Array<juce::var>& r) : options(o), results(r) {}
+
+    template <typename FloatType, typename Prepare, typename Process>
+    void run(const juce::String& stage, const juce::String& variant, Prepare&& prepare, Process&& process)
+    {
+        std::vector<FloatType> buffer;
+
+        for (const double sampleRate : options.sampleRates)
+        {
+            for (const int blockSize : options.blockSizes)
+            {
+                prepare(sampleRate, blockSize);
+                buffer.assign(static_cast<size_t>(blockSize), FloatType(0));
+
+                results.add(measure(makeRecord<FloatType>(stage, variant), options, blockSize, sampleRate, 1,
+                                    [&] { std::copy_n(signal.next(blockSize), blockSize, buffer.data()); },
+                                    [&] { process(buffer.data(), blockSize); },
+                                    [] {}));
+            }
+        }
+
+        std::cerr << "  " << stage << " " << variant << " (" << precisionName<FloatType>() << ")" << std::endl;
+    }
+
+private:
+    const Options& options;
+    juce::Array<juce::var>& results;
+    Signal signal { 0.5f };
+};
+
+template <typename FloatType>
+void benchEngine(StageBench& bench)
+{
+    for (int order = 0; order <= 2; ++order)
+    {
+        BasicSanguinovaEngine<FloatType> engine;
+        bench.run<FloatType>("engine", "adaa=" + juce::String(order),
+                             [&](double, int) { engine.setAntiderivativeOrder(order); engine.setParameters(12.0f, 2.0f); engine.reset(); },
+                             [&](FloatType* data, int n) { engine.processBlock(data, n); });
+    }
+
+    // Plain shaping read from the lookup table instead of exp
+    BasicSanguinovaEngine<FloatType> tableEngine;
+    bench.run<FloatType>("engine", "adaa=0,shaper=table",
+                         [&](double, int) { tableEngine.setLookupTable(true); tableEngine.setParameters(12.0f, 2.0f); tableEngine.reset(); },
+                         [&](FloatType* data, int n) { tableEngine.processBlock(data, n); });
+}
+
+template <typename FloatType>
+void benchSVF(StageBench& bench, const Options& options)
+{
+    std::vector<FloatType> sweep;
+
+    for (const int mode : options.filterModes)
+    {
+        const auto svfMode = static_cast<SVFMode>(mode);
+
+        BasicSVFFilter<FloatType> filter;
+        bench.run<FloatType>("svf", juce::String("mode=") + modeNames[mode] + ",cutoff=static",
+                             [&](double sampleRate, int) { filter.prepare(static_cast<float>(sampleRate)); filter.setParameters(1000.0f, 0.5f); },
+                             [&](FloatType* data, int n) { filter.processBlock(data, n, svfMode); });
+
+        // Audio-rate modulation: a precomputed sweep, one cutoff per sample
+        bench.run<FloatType>("svf", juce::String("mode=") + modeNames[mode] + ",cutoff=per-sample",
+                             [&](double sampleRate, int blockSize)
+                             {
+                                 filter.prepare(static_cast<float>(sampleRate));
+                                 filter.setParameters(1000.0f, 0.5f);
+                                 sweep.resize(static_cast<size_t>(blockSize));
+                                 for (int i = 0; i < blockSize; ++i)
+                                     sweep[static_cast<size_t>(i)] = 1000.0f * std::pow(8.0f, std::sin(juce::MathConstants<float>::twoPi * static_cast<float>(i) / static_cast<float>(blockSize)));
+                             },
+                             [&](FloatType* data, int n) { filter.processBlock(data, sweep.data(), n, svfMode); });
+    }
+}
+
+template <typename FloatType>
+void benchOnePole(StageBench& bench)
+{
+    BasicOnePole<FloatType> filter;
+    bench.run<FloatType>("onepole", "cutoff=8000",
+                         [&](double sampleRate, int) { filter.prepare(static_cast<float>(sampleRate)); filter.setFrequency(8000.0f); },
+                         [&](FloatType* data, int n) { filter.processBlock(data, n); });
+}
+
+template <typename FloatType>
+void benchOversampler(StageBench& bench)
+{
+    // Up and down conversion only: the oversampled callback does nothing
+    for (int factor = 2; factor <= Oversampler::MaxFactor; factor *= 2)
+    {
+        BasicOversampler<FloatType> fir;
+        bench.run<FloatType>("oversampler", "factor=" + juce::String(factor) + ",quality=linear-phase",
+                             [&](double, int blockSize) { fir.prepare(blockSize); fir.setFactor(factor); },
+                             [&](FloatType* data, int n) { fir.processBlock(data, n, [](FloatType*, int) {}); });
+
+        BasicIIROversampler<FloatType> iir;
+        bench.run<FloatType>("oversampler", "factor=" + juce::String(factor) + ",quality=live",
+                             [&](double, int blockSize) { iir.prepare(blockSize); iir.setFactor(factor); },
+                             [&](FloatType* data, int n) { iir.processBlock(data, n, [](FloatType*, int) {}); });
+    }
+}
+
+template <typename FloatType>
+void benchAutoGain(StageBench& bench)
+{
+    // Block envelopes on a dry/wet pair and the gain ramp, with and without look-ahead
+    std::vector<FloatType> dry, gains;
+
+    for (const bool lookahead : { false, true })
+    {
+        BasicAutoGain<FloatType> autoGain;
+        bench.run<FloatType>("autogain", lookahead ? "lookahead=2ms" : "lookahead=off",
+                             [&](double sampleRate, int blockSize)
+                             {
+                                 const int lookaheadSamples = juce::roundToInt(sampleRate * 0.002);
+                                 autoGain.prepare(static_cast<float>(sampleRate), 1, lookaheadSamples);
+                                 autoGain.setLookahead(lookahead ? lookaheadSamples : 0);
+                                 dry.assign(static_cast<size_t>(blockSize), FloatType(0.25));
+                                 gains.resize(static_cast<size_t>(blockSize));
+                             },
+                             [&](FloatType* data, int n)
+                             {
+                                 const FloatType* input = dry.data();
+                                 autoGain.process(&input, &data, 1, n, gains.data());
+                             });
+    }
+}
+
+//==============================================================================
+/** What the plugin's own load meter saw over the same blocks */
+juce::var cpuLoadRecord(const CpuLoadMeter::Stats& stats)
+{
+    auto load = new juce::DynamicObject();
+    load->setProperty("average", stats.average);
+    load->setProperty("peak", stats.peak);
+    load->setProperty("p50", stats.p50);
+    load->setProperty("p95", stats.p95);
+    load->setProperty("p99", stats.p99);
+    load->setProperty("budget", stats.budget);
+    load->setProperty("overruns", static_cast<juce::int64>(stats.overruns));
+    load->setProperty("blocks", static_cast<juce::int64>(stats.blocks));
+    return juce::var(load);
+}
+
+void setParameter(SanguinovaAudioProcessor& processor, const juce::String& id, float value)
+{
+    if (auto* parameter = processor.getState().getParameter(id))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+/** Switch the processor to FloatType's processing path (call before prepareToPlay()) */
+template <typename FloatType>
+void setPrecision(SanguinovaAudioProcessor& processor)
+{
+    processor.setProcessingPrecision(std::is_same_v<FloatType, double> ? juce::AudioProcessor::doublePrecision
+                                                                       : juce::AudioProcessor::singlePrecision);
+}
+
+/** Whole processBlock(): stereo, every chain configuration requested */
+template <typename FloatType>
+void benchChain(const Options& options, juce::Array<juce::var>& results)
+{
+    Signal signal { 0.25f };
+
+    for (const int factor : options.oversampling)
+    for (const int bands : options.bandCounts)
+    for (const int mode : options.filterModes)
+    for (const int stages : options.stageMasks)
+    for (const float mix : options.mixes)
+    {
+        SanguinovaAudioProcessor processor;
+        setPrecision<FloatType>(processor);
+        setParameter(processor, "OVERSAMPLING", static_cast<float>(juce::jlimit(0, 4, static_cast<int>(std::log2(factor)))));
+        setParameter(processor, "OS_QUALITY", options.live ? 1.0f : 0.0f);
+        setParameter(processor, "FILTER_MODE", static_cast<float>(mode));
+        setParameter(processor, "STAGE_2X", (stages & 1) != 0 ? 1.0f : 0.0f);
+        setParameter(processor, "STAGE_5X", (stages & 2) != 0 ? 1.0f : 0.0f);
+        setParameter(processor, "STAGE_10X", (stages & 4) != 0 ? 1.0f : 0.0f);
+        setParameter(processor, "DRIVE", 12.0f);
+        setParameter(processor, "MIX", mix);
+        setParameter(processor, "BANDS", static_cast<float>(juce::jlimit(1, 3, bands) - 1));
+
+        // Full-band variants keep their names, so older reports still diff against them
+        const juce::String variant = "os=" + juce::String(factor) + (options.live ? ",quality=live" : ",quality=linear-phase")
+                                   + (bands > 1 ? ",bands=" + juce::String(bands) : juce::String())
+                                   + ",mode=" + modeNames[mode] + ",stages=" + juce::String(stages)
+                                   + ",mix=" + juce::String(mix);
+
+        for (const double sampleRate : options.sampleRates)
+        {
+            for (const int blockSize : options.blockSizes)
+            {
+                processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+
+                processor.getCpuLoadMeter().setBudget(options.cpuBudget);
+
+                juce::AudioBuffer<FloatType> buffer(2, blockSize);
+                juce::MidiBuffer midi;
+
+                auto record = makeRecord<FloatType>("chain", variant);
+                results.add(measure(record, options, blockSize, sampleRate, 2,
+                                    [&]
+                                    {
+                                        for (int channel = 0; channel < 2; ++channel)
+                                            std::copy_n(signal.next(blockSize), blockSize, buffer.getWritePointer(channel));
+                                    },
+                                    [&] { processor.processBlock(buffer, midi); },
+                                    [&] { processor.getCpuLoadMeter().reset(); }));
+                record->setProperty("cpuLoad", cpuLoadRecord(processor.getCpuLoadMeter().getStats()));
+            }
+        }
+
+        std::cerr << "  chain " << variant << " (" << precisionName<FloatType>() << ")" << std::endl;
+    }
+}
+
+/** Whole processBlock() on digital silence, as on a muted or empty track */
+template <typename FloatType>
+void benchIdle(const Options& options, juce::Array<juce::var>& results)
+{
+    for (const int factor : options.oversampling)
+    {
+        SanguinovaAudioProcessor processor;
+        setPrecision<FloatType>(processor);
+        setParameter(processor, "OVERSAMPLING", static_cast<float>(juce::jlimit(0, 4, static_cast<int>(std::log2(factor)))));
+        setParameter(processor, "OS_QUALITY", options.live ? 1.0f : 0.0f);
+
+        const juce::String variant = "os=" + juce::String(factor) + (options.live ? ",quality=live" : ",quality=linear-phase")
+                                   + ",input=silence";
+
+        for (const double sampleRate : options.sampleRates)
+        {
+            for (const int blockSize : options.blockSizes)
+            {
+                processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+
+                processor.getCpuLoadMeter().setBudget(options.cpuBudget);
+
+                juce::AudioBuffer<FloatType> buffer(2, blockSize);
+                juce::MidiBuffer midi;
+
+                auto record = makeRecord<FloatType>("chain", variant);
+                results.add(measure(record, options, blockSize, sampleRate, 2,
+                                    [&] { buffer.clear(); },
+                                    [&] { processor.processBlock(buffer, midi); },
+                                    [&] { processor.getCpuLoadMeter().reset(); }));
+                record->setProperty("cpuLoad", cpuLoadRecord(processor.getCpuLoadMeter().getStats()));
+            }
+        }
+
+        std::cerr << "  chain " << variant << " (" << precisionName<FloatType>() << ")" << std::endl;
+    }
+}
+
+const char* simdBackend()
+{
+#if SANGUINOVA_SIMD_AVX2
+    return "avx2";
+#elif SANGUINOVA_SIMD_SSE2
+    return "sse2";
+#elif SANGUINOVA_SIMD_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;   // Message manager for the processor, no windows
+    juce::ScopedNoDenormals noDenormals;
+
+    const Options options = parseOptions(juce::ArgumentList(argc, argv));
+    juce::Array<juce::var> results;
+
+    std::cerr << "sanguinova_bench: clock " << CycleClock::name() << " at "
+              << CycleClock::ticksPerSecond() * 1.0e-6 << " MHz" << std::endl;
+
+    StageBench bench(options, results);
+
+    forEachPrecision(options, [&](auto precision)
+    {
+        using FloatType = decltype(precision);
+
+        if (options.suites.contains("engine"))
+            benchEngine<FloatType>(bench);
+        if (options.suites.contains("svf"))
+            benchSVF<FloatType>(bench, options);
+        if (options.suites.contains("onepole"))
+            benchOnePole<FloatType>(bench);
+        if (options.suites.contains("oversampler"))
+            benchOversampler<FloatType>(bench);
+        if (options.suites.contains("autogain"))
+            benchAutoGain<FloatType>(bench);
+        if (options.suites.contains("chain"))
+            benchChain<FloatType>(options, results);
+        if (options.suites.contains("idle"))
+            benchIdle<FloatType>(options, results);
+    });
+
+    auto report = new juce::DynamicObject();
+    report->setProperty("version", 2);   // 2: records carry "precision"
+    report->setProperty("simd", simdBackend());
+    report->setProperty("clock", CycleClock::name());
+    report->setProperty("clockHz", CycleClock::ticksPerSecond());
+    report->setProperty("timePerConfigMs", options.timePerConfigMs);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (options.output != juce::File())
+    {
+        if (! options.output.replaceWithText(json))
+        {
+            std::cerr << "sanguinova_bench: cannot write " << options.output.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,434 @@
+/**
+ * sanguinova_render - Offline batch renderer
+ *
+ * Pushes audio files through SanguinovaAudioProcessor without a host. Each
+ * file streams through a fixed-size chunk buffer (memory does not grow with
+ * file length), files are spread across a worker pool, and the plugin's
+ * latency is compensated so every output lines up with its input.
+ *
+ *   sanguinova_render [--preset=<file.xml | preset name>] [--set=ID=value,...]
+ *                     [--output-dir=<dir>] [--suffix=<text>] [--format=wav|aiff]
+ *                     [--bit-depth=<16|24|32>] [--threads=<n>] [--chunk=<samples>]
+ *                     [--cpu-stats] [--cpu-budget=<percent>] [--trace=<file.json>]
+ *                     <file or directory>...
+ *
+ * Directories are searched recursively for WAV, AIFF and FLAC files. Output
+ * keeps the input's format (FLAC is written as WAV) unless --format is given.
+ * --cpu-stats adds the processor's own load statistics per file (load is
+ * per chunk, relative to the chunk's duration), with chunks over the budget
+ * counted as overruns. --trace (builds with SANGUINOVA_ENABLE_TRACING) writes
+ * the event trace of the whole batch as Chrome trace JSON.
+ */
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "PluginProcessor.h"
+
+#include <iostream>
+
+namespace
+{
+
+//==============================================================================
+struct RenderSettings
+{
+    juce::String preset;                // Preset file path or preset name (empty = defaults)
+    juce::StringPairArray overrides;    // Parameter ID -> value, applied after the preset
+    juce::File outputDirectory;         // Empty = next to each input
+    juce::String suffix { "_sanguinova" };
+    juce::String format;                // "wav", "aiff" or empty to follow the input
+    int bitDepth = 0;                   // 0 = follow the input
+    int chunkSize = 4096;
+    int numThreads = juce::SystemStats::getNumCpus();
+    bool reportCpuLoad = false;
+    juce::File traceFile;               // Empty = no trace
+    float cpuBudget = 1.0f;             // Fraction of real time per chunk
+};
+
+struct RenderResult
+{
+    juce::File input, output;
+    double audioSeconds = 0.0;
+    double renderSeconds = 0.0;
+    CpuLoadMeter::Stats cpuLoad;
+    juce::String error;
+
+    double realtimeFactor() const { return renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0; }
+};
+
+const juce::String audioFilePatterns = "*.wav;*.wave;*.aif;*.aiff;*.flac";
+
+//==============================================================================
+/**
+ * One processor per worker. Processors are built up front on the main
+ * (message) thread; jobs borrow a free one and hand it back when done.
+ */
+class ProcessorPool
+{
+public:
+    explicit ProcessorPool(int size)
+    {
+        for (int i = 0; i < size; ++i)
+            free.add(new SanguinovaAudioProcessor());
+    }
+
+    ~ProcessorPool()
+    {
+        for (auto* processor : free)
+            delete processor;
+    }
+
+    SanguinovaAudioProcessor* acquire()
+    {
+        const juce::ScopedLock lock(mutex);
+        return free.removeAndReturn(free.size() - 1);
+    }
+
+    void release(SanguinovaAudioProcessor* processor)
+    {
+        const juce::ScopedLock lock(mutex);
+        free.add(processor);
+    }
+
+private:
+    juce::CriticalSection mutex;
+    juce::Array<SanguinovaAudioProcessor*> free;
+};
+
+//==============================================================================
+juce::String applySettings(SanguinovaAudioProcessor& processor, const RenderSettings& settings)
+{
+    auto& presets = processor.getPresetManager();
+
+    // Start from the parameter defaults so no state leaks between files
+    for (auto* parameter : processor.getParameters())
+        parameter->setValueNotifyingHost(parameter->getDefaultValue());
+
+    if (settings.preset.isNotEmpty())
+    {
+        const auto presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(settings.preset);
+        const bool loaded = presetFile.existsAsFile() ? presets.loadPresetFromFile(presetFile)
+                                                      : presets.loadPreset(settings.preset);
+        if (! loaded)
+            return "unknown preset '" + settings.preset + "'";
+    }
+
+    for (const auto& id : settings.overrides.getAllKeys())
+    {
+        auto* parameter = processor.getState().getParameter(id);
+        if (parameter == nullptr)
+            return "unknown parameter '" + id + "'";
+
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(settings.overrides[id].getFloatValue()));
+    }
+
+    return {};
+}
+
+juce::AudioFormat* chooseOutputFormat(juce::AudioFormatManager& formats, const juce::File& input,
+                                      const RenderSettings& settings)
+{
+    const juce::String extension = settings.format.isNotEmpty() ? "." + settings.format
+                                                                : input.getFileExtension();
+
+    // FLAC (or anything unrecognised) renders to WAV
+    if (! extension.equalsIgnoreCase(".flac"))
+        if (auto* format = formats.findFormatForFileExtension(extension))
+            return format;
+
+    return formats.findFormatForFileExtension(".wav");
+}
+
+juce::File outputFileFor(const juce::File& input, const juce::AudioFormat& format, const RenderSettings& settings)
+{
+    const auto directory = settings.outputDirectory == juce::File() ? input.getParentDirectory()
+                                                                     : settings.outputDirectory;
+    const auto extension = format.getFileExtensions()[0];
+    return directory.getChildFile(input.getFileNameWithoutExtension() + settings.suffix + extension);
+}
+
+//==============================================================================
+/** Stream one file through the processor, chunk by chunk */
+RenderResult renderFile(SanguinovaAudioProcessor& processor, const juce::File& input, const RenderSettings& settings)
+{
+    RenderResult result;
+    result.input = input;
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+    if (reader == nullptr)
+    {
+        result.error = "cannot read audio";
+        return result;
+    }
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    const double sampleRate = reader->sampleRate;
+    const juce::int64 length = reader->lengthInSamples;
+
+    // Any channel count the plugin accepts, input layout == output layout
+    auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    if (channelSet.isDisabled())
+        channelSet = juce::AudioChannelSet::discreteChannels(numChannels);
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (! processor.setBusesLayout(layout))
+    {
+        result.error = "unsupported channel count " + juce::String(numChannels);
+        return result;
+    }
+
+    if (auto error = applySettings(processor, settings); error.isNotEmpty())
+    {
+        result.error = error;
+        return result;
+    }
+
+    auto* format = chooseOutputFormat(formats, input, settings);
+    result.output = outputFileFor(input, *format, settings);
+
+    if (result.output == input)
+    {
+        result.error = "output would overwrite the input";
+        return result;
+    }
+
+    int bitDepth = settings.bitDepth > 0 ? settings.bitDepth : static_cast<int>(reader->bitsPerSample);
+    if (! format->getPossibleBitDepths().contains(bitDepth))
+        bitDepth = 24;
+
+    result.output.getParentDirectory().createDirectory();
+    auto stream = std::make_unique<juce::FileOutputStream>(result.output);
+    if (! stream->openedOk())
+    {
+        result.error = "cannot write " + result.output.getFullPathName();
+        return result;
+    }
+
+    stream->setPosition(0);
+    stream->truncate();
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+                                                                            static_cast<unsigned int>(numChannels),
+                                                                            bitDepth, reader->metadataValues, 0));
+    if (writer == nullptr)
+    {
+        result.error = "cannot create " + format->getFormatName() + " writer";
+        return result;
+    }
+
+    stream.release();   // Owned by the writer now
+
+    const int chunkSize = settings.chunkSize;
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(sampleRate, chunkSize);
+    processor.prepareToPlay(sampleRate, chunkSize);
+    processor.getCpuLoadMeter().setBudget(settings.cpuBudget);
+
+    // Drop the first latency samples of output and run the same amount of
+    // silence in at the end, so the render is sample-aligned with the input
+    int latencyToSkip = processor.getLatencySamples();
+
+    juce::AudioBuffer<float> buffer(numChannels, chunkSize);
+    juce::MidiBuffer midi;
+    juce::int64 readPosition = 0, written = 0;
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    while (written < length)
+    {
+        // Input, then silence once it runs out (flushes the latency tail)
+        const int numToRead = static_cast<int>(juce::jlimit<juce::int64>(0, chunkSize, length - readPosition));
+        if (numToRead > 0)
+            reader->read(&buffer, 0, numToRead, readPosition, true, true);
+
+        buffer.clear(numToRead, chunkSize - numToRead);
+        readPosition += numToRead;
+
+        processor.processBlock(buffer, midi);
+
+        const int skipped = std::min(latencyToSkip, chunkSize);
+        latencyToSkip -= skipped;
+
+        const int numToWrite = static_cast<int>(std::min<juce::int64>(chunkSize - skipped, length - written));
+        if (numToWrite > 0 && ! writer->writeFromAudioSampleBuffer(buffer, skipped, numToWrite))
+        {
+            result.error = "write failed";
+            break;
+        }
+
+        written += numToWrite;
+    }
+
+    result.cpuLoad = processor.getCpuLoadMeter().getStats();
+    processor.releaseResources();
+
+    result.renderSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    result.audioSeconds = static_cast<double>(length) / sampleRate;
+    return result;
+}
+
+//==============================================================================
+juce::Array<juce::File> collectInputs(const juce::ArgumentList& args)
+{
+    juce::Array<juce::File> files;
+
+    for (const auto& argument : args.arguments)
+    {
+        if (argument.isOption())
+            continue;
+
+        const auto file = argument.resolveAsFile();
+
+        if (file.isDirectory())
+        {
+            auto found = file.findChildFiles(juce::File::findFiles, true, audioFilePatterns);
+            found.sort();
+            files.addArray(found);
+        }
+        else if (file.existsAsFile())
+        {
+            files.add(file);
+        }
+        else
+        {
+            std::cerr << "sanguinova_render: no such file " << file.getFullPathName() << std::endl;
+        }
+    }
+
+    return files;
+}
+
+RenderSettings parseSettings(juce::ArgumentList& args)
+{
+    RenderSettings settings;
+
+    if (args.containsOption("--preset"))
+        settings.preset = args.removeValueForOption("--preset");
+    if (args.containsOption("--output-dir"))
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.removeValueForOption("--output-dir"));
+    if (args.containsOption("--suffix"))
+        settings.suffix = args.removeValueForOption("--suffix");
+    if (args.containsOption("--format"))
+        settings.format = args.removeValueForOption("--format").toLowerCase();
+    if (args.containsOption("--bit-depth"))
+        settings.bitDepth = args.removeValueForOption("--bit-depth").getIntValue();
+    if (args.containsOption("--threads"))
+        settings.numThreads = juce::jmax(1, args.removeValueForOption("--threads").getIntValue());
+    if (args.containsOption("--chunk"))
+        settings.chunkSize = juce::jlimit(16, 65536, args.removeValueForOption("--chunk").getIntValue());
+    if (args.containsOption("--cpu-budget"))
+        settings.cpuBudget = args.removeValueForOption("--cpu-budget").getFloatValue() / 100.0f;
+
+    settings.reportCpuLoad = args.removeOptionIfFound("--cpu-stats");
+
+    if (args.containsOption("--trace"))
+        settings.traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.removeValueForOption("--trace"));
+
+    if (args.containsOption("--set"))
+    {
+        for (const auto& pair : juce::StringArray::fromTokens(args.removeValueForOption("--set"), ",", {}))
+            settings.overrides.set(pair.upToFirstOccurrenceOf("=", false, false).trim(),
+                                   pair.fromFirstOccurrenceOf("=", false, false).trim());
+    }
+
+    return settings;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;   // Message manager for the processors, no windows
+
+    juce::ArgumentList args(argc, argv);
+    const RenderSettings settings = parseSettings(args);
+    const auto inputs = collectInputs(args);
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "usage: sanguinova_render [--preset=<file|name>] [--set=ID=value,...] [--output-dir=<dir>]"
+                     " [--suffix=<text>] [--format=wav|aiff] [--bit-depth=<n>] [--threads=<n>] [--chunk=<n>]"
+                     " [--cpu-stats] [--cpu-budget=<percent>] [--trace=<file>] <file or directory>..." << std::endl;
+        return 1;
+    }
+
+    const int numWorkers = juce::jmin(settings.numThreads, inputs.size());
+    ProcessorPool processors(numWorkers);
+
+    std::vector<RenderResult> results(static_cast<size_t>(inputs.size()));
+    juce::CriticalSection outputLock;
+    const auto batchStart = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool pool(numWorkers);
+
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            pool.addJob([&, i]
+            {
+                auto* processor = processors.acquire();
+                auto& result = results[static_cast<size_t>(i)];
+                result = renderFile(*processor, inputs[i], settings);
+                processors.release(processor);
+
+                const juce::ScopedLock lock(outputLock);
+                if (result.error.isNotEmpty())
+                    std::cerr << "FAILED " << result.input.getFullPathName() << ": " << result.error << std::endl;
+                else
+                    std::cout << result.input.getFileName() << " -> " << result.output.getFullPathName()
+                              << "  " << juce::String(result.audioSeconds, 2) << " s in "
+                              << juce::String(result.renderSeconds, 2) << " s ("
+                              << juce::String(result.realtimeFactor(), 1) << "x realtime)" << std::endl;
+
+                if (result.error.isEmpty() && settings.reportCpuLoad)
+                {
+                    const auto& load = result.cpuLoad;
+                    auto percent = [](float value) { return juce::String(value * 100.0f, 2) + "%"; };
+
+                    std::cout << "    cpu avg " << percent(load.average) << ", p50 " << percent(load.p50)
+                              << ", p95 " << percent(load.p95) << ", p99 " << percent(load.p99)
+                              << ", peak " << percent(load.peak) << ", " << load.overruns << "/" << load.blocks
+                              << " chunks over " << percent(load.budget) << std::endl;
+                }
+            });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(20);
+    }
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - batchStart);
+    double audioSeconds = 0.0;
+    int failures = 0;
+
+    for (const auto& result : results)
+    {
+        audioSeconds += result.audioSeconds;
+        failures += result.error.isNotEmpty() ? 1 : 0;
+    }
+
+    std::cout << inputs.size() - failures << "/" << inputs.size() << " files, "
+              << juce::String(audioSeconds, 1) << " s of audio in " << juce::String(wallSeconds, 1)
+              << " s on " << numWorkers << " threads ("
+              << juce::String(wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0, 1)
+              << "x realtime overall)" << std::endl;
+
+    if (settings.traceFile != juce::File())
+    {
+#if SANGUINOVA_ENABLE_TRACING
+        if (! TraceRecorder::instance().dump(settings.traceFile.getFullPathName().toStdString()))
+            std::cerr << "sanguinova_render: cannot write " << settings.traceFile.getFullPathName() << std::endl;
+#else
+        std::cerr << "sanguinova_render: --trace needs a build with SANGUINOVA_ENABLE_TRACING=ON" << std::endl;
+#endif
+    }
+
+    return failures == 0 ? 0 : 1;
+}